@@ -28,8 +28,10 @@
 
 #include "../containers/relation.hpp"
 #include "../containers/bucket_index.hpp"
+#include "../containers/learned_index.hpp"
 
-bool CompareByEnd(const Record& lhs, const Record& rhs)
+template <typename T>
+bool CompareByEnd(const TemporalRecord<T>& lhs, const TemporalRecord<T>& rhs)
 {
 	return (lhs.end < rhs.end);
 }
@@ -38,14 +40,20 @@ bool CompareByEnd(const Record& lhs, const Record& rhs)
 // Internal loops //
 ////////////////////
 
-inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, const BucketIndex &BI, Timestamp minStart)
+/*
+Internal loops join a group G, sorted by end, with the tuples of the other relation from firstFS on.
+Index gives for an end point the tuples that start before it for sure (lower) and the last one that may (upper),
+either from buckets (TemporalBucketIndex) or from a learned model of the start points (TemporalLearnedIndex)
+*/
+template <typename T, typename Index>
+inline uint64_t bguFS_InternalLoop(TemporalRelation<T> &G, TemporalRecord<T>* firstFS, TemporalRecord<T>* lastFS, const Index &BI, T minStart)
 {
 	uint64_t result = 0;
-	long int cbucket_id, pbucket_id;
+	TemporalRecord<T> *lower, *upper;
 
-	Record* pivot = firstFS;
-	Record* lastG = G.record_list + G.numRecords;
-	for (Record* curr = G.record_list; curr != lastG; curr++)
+	TemporalRecord<T>* pivot = firstFS;
+	TemporalRecord<T>* lastG = G.record_list + G.numRecords;
+	for (TemporalRecord<T>* curr = G.record_list; curr != lastG; curr++)
 	{
 		long int bufferSize = lastG-curr;
 
@@ -54,16 +62,10 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 		if (curr->end < minStart)
 			continue;
 
-		cbucket_id = ceil((double)(curr->end-minStart)/BI.bucket_range);
-		if (cbucket_id >= BI.numBuckets)
-			cbucket_id = BI.numBuckets-1;
-		pbucket_id = ceil((double)(pivot->end-minStart)/BI.bucket_range);
-		if (pbucket_id >= BI.numBuckets)
-			pbucket_id = BI.numBuckets-1;
-
-		if (cbucket_id > pbucket_id)
+		BI.bounds(curr->end, lower, upper);
+		if (lower > pivot)
 		{
-			Record* last = BI.bucket_list[cbucket_id-1].last;
+			TemporalRecord<T>* last = lower;
 			switch (bufferSize)
 			{
 				case 1:
@@ -1105,7 +1107,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 				default:
 					while (last-pivot >= 32)
 					{
-						for (Record* k = curr; k != lastG; k++)
+						for (TemporalRecord<T>* k = curr; k != lastG; k++)
 						{
 #ifdef WORKLOAD_COUNT
 							result += 32;
@@ -1149,7 +1151,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 
 					if (last-pivot >= 16)
 					{
-						for (Record* k = curr; k != lastG; k++)
+						for (TemporalRecord<T>* k = curr; k != lastG; k++)
 						{
 #ifdef WORKLOAD_COUNT
 							result += 16;
@@ -1177,7 +1179,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 
 					if (last-pivot >= 8)
 					{
-						for (Record* k = curr; k != lastG; k++)
+						for (TemporalRecord<T>* k = curr; k != lastG; k++)
 						{
 #ifdef WORKLOAD_COUNT
 							result += 8;
@@ -1197,7 +1199,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 
 					if (last-pivot >= 4)
 					{
-						for (Record* k = curr; k != lastG; k++)
+						for (TemporalRecord<T>* k = curr; k != lastG; k++)
 						{
 #ifdef WORKLOAD_COUNT
 							result += 4;
@@ -1213,7 +1215,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 
 					while (pivot < last)
 					{
-						Record* k = curr;
+						TemporalRecord<T>* k = curr;
 						while (lastG-k >= 32)
 						{
 #ifdef WORKLOAD_COUNT
@@ -1327,10 +1329,10 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 		}
 /*
 		// Sweep the last bucket.
-		Record* last = BI.bucket_list[cbucket_id].last;
+		TemporalRecord<T>* last = upper;
 		while ((pivot != last) && (curr->end > pivot->start))
 		{
-			for (Record* k = curr; k != lastG; k++)
+			for (TemporalRecord<T>* k = curr; k != lastG; k++)
 			{
 #ifdef WORKLOAD_COUNT
 				result += 1;
@@ -1342,7 +1344,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 		}
 */
 		// Sweep the last bucket.
-		Record* last = BI.bucket_list[cbucket_id].last;
+		TemporalRecord<T>* last = upper;
 		switch (bufferSize)
 		{
 			case 1:
@@ -2384,7 +2386,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 			default:
 				while ((last-pivot >= 32) && (curr->end > (pivot+31)->start))
 				{
-					for (Record* k = curr; k != lastG; k++)
+					for (TemporalRecord<T>* k = curr; k != lastG; k++)
 					{
 #ifdef WORKLOAD_COUNT
 						result += 32;
@@ -2428,7 +2430,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 
 				if ((last-pivot >= 16) && (curr->end > (pivot+15)->start))
 				{
-					for (Record* k = curr; k != lastG; k++)
+					for (TemporalRecord<T>* k = curr; k != lastG; k++)
 					{
 #ifdef WORKLOAD_COUNT
 						result += 16;
@@ -2456,7 +2458,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 
 				if ((last-pivot >= 8) && (curr->end > (pivot+7)->start))
 				{
-					for (Record* k = curr; k != lastG; k++)
+					for (TemporalRecord<T>* k = curr; k != lastG; k++)
 					{
 #ifdef WORKLOAD_COUNT
 						result += 8;
@@ -2476,7 +2478,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 
 				if ((last-pivot >= 4) && (curr->end > (pivot+3)->start))
 				{
-					for (Record* k = curr; k != lastG; k++)
+					for (TemporalRecord<T>* k = curr; k != lastG; k++)
 					{
 #ifdef WORKLOAD_COUNT
 						result += 4;
@@ -2492,7 +2494,7 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 
 				while ((pivot < last) && (pivot->start < curr->end))
 				{
-					Record* k = curr;
+					TemporalRecord<T>* k = curr;
 					while (lastG-k >= 32)
 					{
 #ifdef WORKLOAD_COUNT
@@ -2610,33 +2612,28 @@ inline uint64_t bguFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, co
 }
 
 
-inline uint64_t bgFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, const BucketIndex &BI, Timestamp minStart)
+template <typename T, typename Index>
+inline uint64_t bgFS_InternalLoop(TemporalRelation<T> &G, TemporalRecord<T>* firstFS, TemporalRecord<T>* lastFS, const Index &BI, T minStart)
 {
 	uint64_t result = 0;
-	long int cbucket_id, pbucket_id;
+	TemporalRecord<T> *lower, *upper;
 
-	Record* pivot = firstFS;
-	Record* lastG = &G.record_list[G.numRecords-1] + 1;
-	for (Record* curr = &G.record_list[0]; curr != lastG; curr++)
+	TemporalRecord<T>* pivot = firstFS;
+	TemporalRecord<T>* lastG = &G.record_list[G.numRecords-1] + 1;
+	for (TemporalRecord<T>* curr = &G.record_list[0]; curr != lastG; curr++)
 	{
 		if (pivot == lastFS)
 			break;
 		if (curr->end < minStart)
 			continue;
 
-		cbucket_id = ceil((double)(curr->end-minStart)/BI.bucket_range);
-		if (cbucket_id >= BI.numBuckets)
-			cbucket_id = BI.numBuckets-1;
-		pbucket_id = ceil((double)(pivot->end-minStart)/BI.bucket_range);
-		if (pbucket_id >= BI.numBuckets)
-			pbucket_id = BI.numBuckets-1;
-
-		if (cbucket_id > pbucket_id)
+		BI.bounds(curr->end, lower, upper);
+		if (lower > pivot)
 		{
-			Record* last = BI.bucket_list[cbucket_id-1].last;
+			TemporalRecord<T>* last = lower;
 			while (pivot != last)
 			{
-				for (Record* k = curr; k != lastG; k++)
+				for (TemporalRecord<T>* k = curr; k != lastG; k++)
 				{
 #ifdef WORKLOAD_COUNT
 					result += 1;
@@ -2649,10 +2646,10 @@ inline uint64_t bgFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, con
 		}
 
 		// Sweep the last bucket.
-		Record* last = BI.bucket_list[cbucket_id].last;
+		TemporalRecord<T>* last = upper;
 		while ((pivot != last) && (curr->end > pivot->start))
 		{
-			for (Record* k = curr; k != lastG; k++)
+			for (TemporalRecord<T>* k = curr; k != lastG; k++)
 			{
 #ifdef WORKLOAD_COUNT
 				result += 1;
@@ -2672,14 +2669,16 @@ inline uint64_t bgFS_InternalLoop(Group &G, Record* firstFS, Record* lastFS, con
 // Single-thread processing //
 //////////////////////////////
 
-uint64_t bguFS(Relation &R, Relation &S, BucketIndex &BIR, BucketIndex &BIS)
+/* forward scan with grouping and buckets (or a learned index) - internal loops are unrolled if unrolled is set */
+template <typename T, bool unrolled, typename Index>
+uint64_t grouped_FS(TemporalRelation<T> &R, TemporalRelation<T> &S, Index &BIR, Index &BIS)
 {
 	uint64_t result = 0;
-	Record* r = R.record_list;
-	Record* s = S.record_list;
-	Record* lastR = R.record_list + R.numRecords;
-	Record* lastS = S.record_list + S.numRecords;
-	Group GR, GS;
+	TemporalRecord<T>* r = R.record_list;
+	TemporalRecord<T>* s = S.record_list;
+	TemporalRecord<T>* lastR = R.record_list + R.numRecords;
+	TemporalRecord<T>* lastS = S.record_list + S.numRecords;
+	TemporalRelation<T> GR, GS;
 	size_t i;
 	
 	while ((r < lastR) && (s < lastS))
@@ -2693,19 +2692,19 @@ uint64_t bguFS(Relation &R, Relation &S, BucketIndex &BIR, BucketIndex &BIS)
 				r++;
 			}
 			r -= GR.numRecords;
-			GR.record_list = (Record*) malloc(GR.numRecords*sizeof(Record));
+			GR.record_list = (TemporalRecord<T>*) malloc(GR.numRecords*sizeof(TemporalRecord<T>));
 			i = 0;
 			while ((r < lastR) && (r->start < s->start))
 			{
-				GR.record_list[i++] = Record(r->start, r->end);
+				GR.record_list[i++] = TemporalRecord<T>(r->start, r->end);
 				r++;
 			}
 
 			// Sort current group by end point.
-			std::sort( &GR.record_list[0], &GR.record_list[0] + GR.numRecords, CompareByEnd);
+			std::sort( &GR.record_list[0], &GR.record_list[0] + GR.numRecords, CompareByEnd<T>);
 
 			// Step 2: run internal loop.
-			result += bguFS_InternalLoop(GR, s, lastS, BIS, S.minStart);
+			result += unrolled ? bguFS_InternalLoop(GR, s, lastS, BIS, S.minStart) : bgFS_InternalLoop(GR, s, lastS, BIS, S.minStart);
 
 			// Step 3: empty current group.
 			free(GR.record_list);
@@ -2721,19 +2720,19 @@ uint64_t bguFS(Relation &R, Relation &S, BucketIndex &BIR, BucketIndex &BIS)
 				s++;
 			}
 			s -= GS.numRecords;
-			GS.record_list = (Record*) malloc(GS.numRecords*sizeof(Record));
+			GS.record_list = (TemporalRecord<T>*) malloc(GS.numRecords*sizeof(TemporalRecord<T>));
 			i = 0;
 			while ((s < lastS) && (r->start >= s->start))
 			{
-				GS.record_list[i++] = Record(s->start, s->end);
+				GS.record_list[i++] = TemporalRecord<T>(s->start, s->end);
 				s++;
 			}
 
 			// Sort current group by end point.
-			std::sort( &GS.record_list[0], &GS.record_list[0] + GS.numRecords, CompareByEnd);
+			std::sort( &GS.record_list[0], &GS.record_list[0] + GS.numRecords, CompareByEnd<T>);
 
 			// Step 2: run internal loop.
-			result += bguFS_InternalLoop(GS, r, lastR, BIR, R.minStart);
+			result += unrolled ? bguFS_InternalLoop(GS, r, lastR, BIR, R.minStart) : bgFS_InternalLoop(GS, r, lastR, BIR, R.minStart);
 
 			// Step 3: empty current group.
 			free(GS.record_list);
@@ -2743,4 +2742,98 @@ uint64_t bguFS(Relation &R, Relation &S, BucketIndex &BIR, BucketIndex &BIS)
 	}
 	
 	return result;
-}
\ No newline at end of file
+}
+
+template <typename T>
+uint64_t bguFS(TemporalRelation<T> &R, TemporalRelation<T> &S, TemporalBucketIndex<T> &BIR, TemporalBucketIndex<T> &BIS)
+{
+	return grouped_FS<T, true>(R, S, BIR, BIS);
+}
+
+/* bguFS with learned indexes over the start points instead of buckets */
+template <typename T>
+uint64_t bguFS(TemporalRelation<T> &R, TemporalRelation<T> &S, TemporalLearnedIndex<T> &LIR, TemporalLearnedIndex<T> &LIS)
+{
+	return grouped_FS<T, true>(R, S, LIR, LIS);
+}
+
+template <typename T>
+uint64_t bgFS(TemporalRelation<T> &R, TemporalRelation<T> &S, TemporalBucketIndex<T> &BIR, TemporalBucketIndex<T> &BIS)
+{
+	return grouped_FS<T, false>(R, S, BIR, BIS);
+}
+
+/* plain forward scan: each tuple scans the other relation from the current position, while tuples start before its end */
+template <typename T>
+uint64_t FS(TemporalRelation<T> &R, TemporalRelation<T> &S)
+{
+	uint64_t result = 0;
+	TemporalRecord<T>* r = R.record_list;
+	TemporalRecord<T>* s = S.record_list;
+	TemporalRecord<T>* lastR = R.record_list + R.numRecords;
+	TemporalRecord<T>* lastS = S.record_list + S.numRecords;
+
+	while ((r < lastR) && (s < lastS))
+	{
+		if (*r < *s)
+		{
+			for (TemporalRecord<T>* k = s; (k < lastS) && (k->start < r->end); k++)
+			{
+#ifdef WORKLOAD_COUNT
+				result += 1;
+#else
+				result += r->start ^ k->start;
+#endif
+			}
+			r++;
+		}
+		else
+		{
+			for (TemporalRecord<T>* k = r; (k < lastR) && (k->start < s->end); k++)
+			{
+#ifdef WORKLOAD_COUNT
+				result += 1;
+#else
+				result += k->start ^ s->start;
+#endif
+			}
+			s++;
+		}
+	}
+
+	return result;
+}
+
+/*
+Picks the forward scan to join a group pair with:
+FS for small pairs, that don't pay for the bucket indexes and the sorting of grouping,
+bgFS if a tuple overlaps with few tuples of the other relation on average, too few to fill the unrolled loops, else bguFS
+*/
+template <typename T>
+int fs_variant(const TemporalRelation<T> &R, const TemporalRelation<T> &S)
+{
+	if (R.numRecords + S.numRecords <= 32)
+		return PLAIN_FS;
+
+	// average overlaps of a tuple: tuples of the other relation in a window of its average length
+	double lengthR = 0, lengthS = 0;
+	for (size_t i = 0; i < R.numRecords; i++)
+		lengthR += R.record_list[i].end - R.record_list[i].start;
+	for (size_t i = 0; i < S.numRecords; i++)
+		lengthS += S.record_list[i].end - S.record_list[i].start;
+	double span = (double) std::max(R.maxStart, S.maxStart) - (double) std::min(R.minStart, S.minStart) + 1;
+	double overlaps = (lengthR + lengthS) / span;
+
+	return (overlaps < 8) ? BG_FS : BGU_FS;
+}
+
+template uint64_t bguFS<Timestamp>(Relation &R, Relation &S, BucketIndex &BIR, BucketIndex &BIS);
+template uint64_t bguFS<ShortTimestamp>(ShortRelation &R, ShortRelation &S, TemporalBucketIndex<ShortTimestamp> &BIR, TemporalBucketIndex<ShortTimestamp> &BIS);
+template uint64_t bguFS<Timestamp>(Relation &R, Relation &S, LearnedIndex &LIR, LearnedIndex &LIS);
+template uint64_t bguFS<ShortTimestamp>(ShortRelation &R, ShortRelation &S, TemporalLearnedIndex<ShortTimestamp> &LIR, TemporalLearnedIndex<ShortTimestamp> &LIS);
+template uint64_t bgFS<Timestamp>(Relation &R, Relation &S, BucketIndex &BIR, BucketIndex &BIS);
+template uint64_t bgFS<ShortTimestamp>(ShortRelation &R, ShortRelation &S, TemporalBucketIndex<ShortTimestamp> &BIR, TemporalBucketIndex<ShortTimestamp> &BIS);
+template uint64_t FS<Timestamp>(Relation &R, Relation &S);
+template uint64_t FS<ShortTimestamp>(ShortRelation &R, ShortRelation &S);
+template int fs_variant<Timestamp>(const Relation &R, const Relation &S);
+template int fs_variant<ShortTimestamp>(const ShortRelation &R, const ShortRelation &S);
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/relation.hpp"
+#include "../containers/placement.hpp"
+
+// findBorders
+void chunk_to_read(Position size, uint32_t c, uint32_t chunk, Position &toTakeStart, Position &toTakeEnd);
+
+struct structForParallelCompact
+{
+	uint32_t c;				// number of threads
+	uint32_t chunk;				// thread id [0,c)
+	ExtendedRelation *rel;			// relation to compact
+};
+
+void* compact_set(void* args)
+{
+	structForParallelCompact* gained = (structForParallelCompact*) args;
+
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+
+	for (Position i = toTakeStart-1; i < toTakeEnd; i++)
+		gained->rel->setSorted( i, gained->rel->record_list[i].start, gained->rel->record_list[i].end, gained->rel->record_list[i].key);
+
+	return NULL;
+}
+
+/*
+Sets the tuples after sorting of a relation, once its Borders are found.
+If COMPACT_RECORDS is set, tuples are rewritten in parallel without their non-temporal values, which are then kept only in Borders,
+so every later scan reads 16 instead of 24 bytes per tuple. If SOA_RECORDS is set, they are rewritten to a start and an end column,
+so that scans of one of them read 8 bytes per tuple. Otherwise sorted_list is record_list.
+Chunk i is written by thread i of placement, so the tuples are first-touched on the memory node of the thread that joins them
+*/
+void compact_relation( ExtendedRelation& R, ThreadPlacement& placement, uint32_t c)
+{
+#if defined(COMPACT_RECORDS) || defined(SOA_RECORDS)
+	pthread_t threads[c];
+	structForParallelCompact toPass[c];
+
+	R.allocateSorted( R.numRecords );
+	for (uint32_t i = 0; i < c; i++)
+	{
+		toPass[i].c = c;
+		toPass[i].chunk = i;
+		toPass[i].rel = &R;
+		pthread_create( &threads[i], placement.attr(i), compact_set, &toPass[i]);
+	}
+	for (uint32_t i = 0; i < c; i++)
+	{
+		pthread_join( threads[i], NULL);
+	}
+
+	large_free( R.record_list );
+	R.record_list = NULL;
+#else
+	R.sorted_list = R.record_list;
+#endif
+}
+
+void mainCompact( ExtendedRelation& R, ExtendedRelation& S, ThreadPlacement& placement, uint32_t c)
+{
+	#ifdef TIMES
+	Timer tim;
+	tim.start();
+	#endif
+
+	compact_relation( R, placement, c);
+	compact_relation( S, placement, c);
+
+	#ifdef TIMES
+	double timeCompact = tim.stop();
+	std::cout << "Compact time: " << timeCompact << std::endl;
+	report_large_allocations("compact");
+	#endif
+}
@@ -28,6 +28,7 @@
 
 #include "../containers/relation.hpp"
 #include "../containers/borders.hpp"
+#include "../containers/placement.hpp"
 
 // used to get the id of an available thread
 uint32_t getThreadId(bool& needsDetach, uint32_t* jobsList, uint32_t& jobsListSize);
@@ -42,8 +43,7 @@ struct structForParallelComplement
 	ExtendedRelation* complement;		// place to save complement
 	Borders* borders_complement;		// border information to be set for complement relation
 	uint32_t group_id;			// id of current group [0,groups_num-1]
-	uint32_t group1;			// group1 value to compute complement
-	uint32_t group2;			// group2 value to compute complement
+	GroupKey key;				// non-temporal values to compute complement
 
 	uint32_t runNumThreads;				// number of threads
 	uint32_t chunk;				// thread id [0,c)
@@ -54,20 +54,20 @@ void* find_complement_sizes(void *args)
 {
 	structForParallelComplement* gained = (structForParallelComplement*) args;
 
-	uint32_t count=0;
+	Position count=0;
 	Timestamp last = gained->domainStart;
 
 	// find size of current group
-	for (uint32_t i = gained->borders->borders_list[gained->group_id].position_start; i <= gained->borders->borders_list[gained->group_id].position_end; i++)
+	for (Position i = gained->borders->borders_list[gained->group_id].position_start; i <= gained->borders->borders_list[gained->group_id].position_end; i++)
 	{
-		if (last < gained->rel->record_list[i].start)
+		if (last < gained->rel->getStart(i))
 		{
-			last = gained->rel->record_list[i].end;
+			last = gained->rel->getEnd(i);
 			count++;
 		}
-		else if (last < gained->rel->record_list[i].end)
+		else if (last < gained->rel->getEnd(i))
 		{
-			last = gained->rel->record_list[i].end;
+			last = gained->rel->getEnd(i);
 		}
 	}
 	if (last < gained->domainEnd)
@@ -88,44 +88,54 @@ void* set_complement(void* args)
 {
 	structForParallelComplement* gained = (structForParallelComplement*) args;
 
-	uint32_t point_to_write = gained->each_group_sizes[gained->group_id];
+	Position point_to_write = gained->each_group_sizes[gained->group_id];
 	Timestamp last = gained->domainStart;
+	Timestamp sumLength = 0;
 	bool write_flag = false;
 
 	// set complement
-	for (uint32_t i = gained->borders->borders_list[gained->group_id].position_start; i <= gained->borders->borders_list[gained->group_id].position_end; i++)
+	for (Position i = gained->borders->borders_list[gained->group_id].position_start; i <= gained->borders->borders_list[gained->group_id].position_end; i++)
 	{
-		if (last < gained->rel->record_list[i].start)
+		if (last < gained->rel->getStart(i))
 		{
 			write_flag = true;
-			gained->complement->record_list[point_to_write] = ExtendedRecord(last, gained->rel->record_list[i].start, gained->group1, gained->group2);
-			last = gained->rel->record_list[i].end;
+			gained->complement->setSorted(point_to_write, last, gained->rel->getStart(i), gained->key);
+			sumLength += gained->rel->getStart(i) - last;
+			last = gained->rel->getEnd(i);
 			point_to_write++;
 		}
-		else if (last < gained->rel->record_list[i].end)
+		else if (last < gained->rel->getEnd(i))
 		{
-			last = gained->rel->record_list[i].end;
+			last = gained->rel->getEnd(i);
 		}
 	}
 	if (last < gained->domainEnd)
 	{
 		write_flag = true;
-		gained->complement->record_list[point_to_write] = ExtendedRecord(last, gained->domainEnd, gained->group1, gained->group2);
+		gained->complement->setSorted(point_to_write, last, gained->domainEnd, gained->key);
+		sumLength += gained->domainEnd - last;
 		point_to_write++;
 	}
 
 	// set borders for current group (set an error border in case of an empty complement)
 	if (write_flag)
 	{
-		gained->borders_complement->borders_list[gained->group_id].group1 = gained->borders->borders_list[gained->group_id].group1;
-		gained->borders_complement->borders_list[gained->group_id].group2 = gained->borders->borders_list[gained->group_id].group2;
+		gained->borders_complement->borders_list[gained->group_id].key = gained->borders->borders_list[gained->group_id].key;
 		gained->borders_complement->borders_list[gained->group_id].position_start = gained->each_group_sizes[gained->group_id];
 		gained->borders_complement->borders_list[gained->group_id].position_end = point_to_write - 1;
+
+		// complement intervals of a group are disjoint and ordered, so first and last one give its zone map
+		size_t first_gap = gained->each_group_sizes[gained->group_id];
+		size_t last_gap = point_to_write - 1;
+		gained->borders_complement->borders_list[gained->group_id].minStart = gained->complement->getStart(first_gap);
+		gained->borders_complement->borders_list[gained->group_id].maxStart = gained->complement->getStart(last_gap);
+		gained->borders_complement->borders_list[gained->group_id].minEnd = gained->complement->getEnd(first_gap);
+		gained->borders_complement->borders_list[gained->group_id].maxEnd = gained->complement->getEnd(last_gap);
+		gained->borders_complement->borders_list[gained->group_id].sumLength = sumLength;
 	}
 	else
 	{
-		gained->borders_complement->borders_list[gained->group_id].group1 = gained->borders->borders_list[gained->group_id].group1;
-		gained->borders_complement->borders_list[gained->group_id].group2 = gained->borders->borders_list[gained->group_id].group2;
+		gained->borders_complement->borders_list[gained->group_id].key = gained->borders->borders_list[gained->group_id].key;
 		gained->borders_complement->borders_list[gained->group_id].position_start = 1;
 		gained->borders_complement->borders_list[gained->group_id].position_end = 0;
 	}
@@ -138,7 +148,7 @@ void* set_complement(void* args)
 
 void convert_to_complement( ExtendedRelation& R, Borders& borders,
 							ExtendedRelation& complement, Borders& borders_complement,
-							Timestamp foreignStart, Timestamp foreignEnd, uint32_t runNumThreads)
+							Timestamp foreignStart, Timestamp foreignEnd, ThreadPlacement& placement, uint32_t runNumThreads)
 
 {
 	#ifdef TIMES
@@ -182,14 +192,13 @@ void convert_to_complement( ExtendedRelation& R, Borders& borders,
 		toPass[threadId].borders = &borders;
 		toPass[threadId].each_group_sizes = each_group_sizes;
 		toPass[threadId].group_id = current_group_id;
-		toPass[threadId].group1 = borders.borders_list[i].group1;
-		toPass[threadId].group2 = borders.borders_list[i].group2;
+		toPass[threadId].key = borders.borders_list[i].key;
 
 		toPass[threadId].runNumThreads = runNumThreads;
 		toPass[threadId].chunk = threadId;
 		toPass[threadId].jobsList = jobsList;
 
-		pthread_create( &threads[threadId], NULL, find_complement_sizes, &toPass[threadId]);
+		pthread_create( &threads[threadId], placement.attr(threadId), find_complement_sizes, &toPass[threadId]);
 
 		// next group
 		current_group_id++;
@@ -202,14 +211,14 @@ void convert_to_complement( ExtendedRelation& R, Borders& borders,
 	////////////////////////////////////////////////////////////////////////////////////////////////
 
 	// calculate full size of complement, change group sizes to points that each group should begin at new table
-	uint32_t total = 0, previous_total;
+	Position total = 0, previous_total;
 	for (uint32_t i=0; i < borders.numBorders; i++)
 	{
 		previous_total = total;
 		total += each_group_sizes[i];
 		each_group_sizes[i] = previous_total;
 	}
-	complement.record_list = (ExtendedRecord*) malloc( total * sizeof(ExtendedRecord) );
+	complement.allocateSorted( total );
 	complement.numRecords = total;
 
 	/////////////////////////////////////// set complement /////////////////////////////////////////
@@ -234,14 +243,13 @@ void convert_to_complement( ExtendedRelation& R, Borders& borders,
 		toPass[threadId].complement = &complement;
 		toPass[threadId].borders_complement = &borders_complement;
 		toPass[threadId].group_id = current_group_id;
-		toPass[threadId].group1 = borders.borders_list[i].group1;
-		toPass[threadId].group2 = borders.borders_list[i].group2;
+		toPass[threadId].key = borders.borders_list[i].key;
 
 		toPass[threadId].runNumThreads = runNumThreads;
 		toPass[threadId].chunk = threadId;
 		toPass[threadId].jobsList = jobsList;
 
-		pthread_create( &threads[threadId], NULL, set_complement, &toPass[threadId]);
+		pthread_create( &threads[threadId], placement.attr(threadId), set_complement, &toPass[threadId]);
 
 		// next group
 		current_group_id++;
@@ -259,5 +267,6 @@ void convert_to_complement( ExtendedRelation& R, Borders& borders,
 	#ifdef TIMES
 	double timeComplement = tim.stop();
 	std::cout << "Complement time: " << timeComplement << " and size " << complement.numRecords << std::endl;
+	report_large_allocations("complement");
 	#endif
 }
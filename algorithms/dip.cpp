@@ -28,58 +28,62 @@
 
 #include "../containers/relation.hpp"
 
+template <typename T>
 class dip_heap_node
 {
 public:
-	Timestamp max_end_point;
-	std::vector<Record> partition;
+	T max_end_point;
+	std::vector<TemporalRecord<T>> partition;
 
-	dip_heap_node(Record r)
+	dip_heap_node(TemporalRecord<T> r)
 	{
 		this->max_end_point = r.end;
 		this->partition.push_back(r);
 	}
 };
 
-bool heapComparison( dip_heap_node a, dip_heap_node b )
+template <typename T>
+bool heapComparison( dip_heap_node<T> a, dip_heap_node<T> b )
 {
 	return a.max_end_point < b.max_end_point;
 }
 
-void create_dip(Relation& R, std::vector<dip_heap_node>& heap_r)
+template <typename T>
+void create_dip(TemporalRelation<T>& R, std::vector<dip_heap_node<T>>& heap_r)
 {
-	heap_r.push_back( dip_heap_node(R.record_list[0]) );
-	for (uint32_t i = 1; i != R.numRecords; i++)
+	heap_r.push_back( dip_heap_node<T>(R.record_list[0]) );
+	for (size_t i = 1; i != R.numRecords; i++)
 	{
 		if ( heap_r.front().max_end_point > R.record_list[i].start )
 		{
-			heap_r.push_back( dip_heap_node(R.record_list[i]) );
+			heap_r.push_back( dip_heap_node<T>(R.record_list[i]) );
 
-			push_heap( heap_r.begin(), heap_r.end(), heapComparison);
+			push_heap( heap_r.begin(), heap_r.end(), heapComparison<T>);
 		}
 		else
 		{
 			heap_r[0].max_end_point = R.record_list[i].end;
 			heap_r[0].partition.push_back( R.record_list[i] );
 
-			pop_heap( heap_r.begin(), heap_r.end(), heapComparison);
-			push_heap( heap_r.begin(), heap_r.end(), heapComparison);
+			pop_heap( heap_r.begin(), heap_r.end(), heapComparison<T>);
+			push_heap( heap_r.begin(), heap_r.end(), heapComparison<T>);
 		}
 	}
 }
 
-uint64_t o_dip_merge_anti( std::vector<dip_heap_node>& heap_r, Relation& S, Timestamp& domainStart, Timestamp& domainEnd)
+template <typename T>
+uint64_t o_dip_merge_anti( std::vector<dip_heap_node<T>>& heap_r, TemporalRelation<T>& S, T& domainStart, T& domainEnd)
 {
 	uint64_t result = 0;
 
 	// lead variables
-	Timestamp longestS = domainStart;
-	Timestamp leadStart, leadEnd;
+	T longestS = domainStart;
+	T leadStart, leadEnd;
 
 	// initialize current and end position for pointers in heap_r
 	size_t partitions_num = heap_r.size();
-	Record** currentR = (Record**) malloc( partitions_num * sizeof(Record*) );
-	Record** endR = (Record**) malloc( partitions_num * sizeof(Record*) );
+	TemporalRecord<T>** currentR = (TemporalRecord<T>**) malloc( partitions_num * sizeof(TemporalRecord<T>*) );
+	TemporalRecord<T>** endR = (TemporalRecord<T>**) malloc( partitions_num * sizeof(TemporalRecord<T>*) );
 	for (uint32_t i = 0; i < partitions_num; i++)
 	{
 		currentR[i] = &heap_r[i].partition[0];
@@ -87,8 +91,8 @@ uint64_t o_dip_merge_anti( std::vector<dip_heap_node>& heap_r, Relation& S, Time
 	}
 
 	// scan S and get s.X in every step of the loop
-	Record* currentS = S.record_list;
-	Record* lastS = S.record_list + S.numRecords;
+	TemporalRecord<T>* currentS = S.record_list;
+	TemporalRecord<T>* lastS = S.record_list + S.numRecords;
 	while (currentS != lastS)
 	{
 		// get s.X, scan partitions for overlaps, if its > 0
@@ -169,14 +173,15 @@ uint64_t o_dip_merge_anti( std::vector<dip_heap_node>& heap_r, Relation& S, Time
 	return result;
 }
 
-uint64_t o_dip_anti(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd)
+template <typename T>
+uint64_t o_dip_anti(TemporalRelation<T>& R, TemporalRelation<T>& S, T& domainStart, T& domainEnd)
 {
 	#ifdef TIMES
 	Timer tim;
 	tim.start();
 	#endif
 
-	std::vector<dip_heap_node> heap_r;
+	std::vector<dip_heap_node<T>> heap_r;
 	create_dip( R, heap_r);
 
 	#ifdef TIMES
@@ -195,17 +200,18 @@ uint64_t o_dip_anti(Relation& R, Relation& S, Timestamp& domainStart, Timestamp&
 	return result;
 }
 
-uint64_t dip_merge_anti( std::vector<dip_heap_node>& heap_r, Relation& S, Timestamp& domainStart, Timestamp& domainEnd)
+template <typename T>
+uint64_t dip_merge_anti( std::vector<dip_heap_node<T>>& heap_r, TemporalRelation<T>& S, T& domainStart, T& domainEnd)
 {
 	// DIPmerge variables and result (We consider that null timepoint is +INFINITY)
 	uint64_t result = 0;
-	const Timestamp null_timepoint = (0 - 1);
+	const T null_timepoint = (0 - 1);
 	const uint32_t m = heap_r.size();
 
 	// load r
-	Record** current_r = (Record**) malloc( m*sizeof(Record*) );
-	Record** end_r = (Record**) malloc( m*sizeof(Record*) );
-	Record* r = (Record*) malloc( m*sizeof(Record) );
+	TemporalRecord<T>** current_r = (TemporalRecord<T>**) malloc( m*sizeof(TemporalRecord<T>*) );
+	TemporalRecord<T>** end_r = (TemporalRecord<T>**) malloc( m*sizeof(TemporalRecord<T>*) );
+	TemporalRecord<T>* r = (TemporalRecord<T>*) malloc( m*sizeof(TemporalRecord<T>) );
 	bool* r_nulls = (bool*) malloc( m*sizeof(bool) );
 	for (uint32_t i = 0; i < m; i++)
 	{
@@ -218,14 +224,14 @@ uint64_t dip_merge_anti( std::vector<dip_heap_node>& heap_r, Relation& S, Timest
 
 	// load s
 	// DIP considers domainStart = -INFINITY, so we need some extra cleaning before main loop
-	Record* current_s = S.record_list;
-	const Record* end_s = S.record_list + S.numRecords;
-	std::pair<Record,Record> s;
+	TemporalRecord<T>* current_s = S.record_list;
+	const TemporalRecord<T>* end_s = S.record_list + S.numRecords;
+	std::pair<TemporalRecord<T>,TemporalRecord<T>> s;
 	bool s_null = false;
 	// fetchRow(S)
 	s.first = *current_s++;
-	s.second = Record( domainStart, s.first.start );
-	Timestamp longestS = domainStart;
+	s.second = TemporalRecord<T>( domainStart, s.first.start );
+	T longestS = domainStart;
 	while (s.second.start >= s.second.end)
 	{
 		// fetchRow(S)
@@ -233,25 +239,26 @@ uint64_t dip_merge_anti( std::vector<dip_heap_node>& heap_r, Relation& S, Timest
 			s_null = true;
 		else
 			s.first = *current_s++;;
-		longestS = std::max( (current_s-2)->end, longestS);
 		if (s_null)
 		{
+			// no tuple was fetched, so current_s-1 is the previous tuple (current_s-2 may be before S if it has one tuple)
 			longestS = std::max( (current_s-1)->end, longestS);
 			s.first.start = null_timepoint;
 			if (longestS == domainEnd)
 				return 0;
 			else
-				s.second = Record( longestS, domainEnd);
+				s.second = TemporalRecord<T>( longestS, domainEnd);
 			break;
 		}
 		else
 		{
-			s.second = Record( longestS, (current_s-1)->start);
+			longestS = std::max( (current_s-2)->end, longestS);
+			s.second = TemporalRecord<T>( longestS, (current_s-1)->start);
 		}
 	}
 
 	// main loop
-	Timestamp i = 0;
+	T i = 0;
 	while ( (r[i].start != null_timepoint) || (s.first.start != null_timepoint) )
 	{
 		if ( (s.second.start < s.second.end) && ( (r[i].start < s.second.end) && (s.second.start < r[i].end) ) ) // overlap check
@@ -293,23 +300,23 @@ uint64_t dip_merge_anti( std::vector<dip_heap_node>& heap_r, Relation& S, Timest
 
 				if (!s_null)
 				{
-					s.second = Record(longestS, s.first.start);
+					s.second = TemporalRecord<T>(longestS, s.first.start);
 				}
 				else
 				{
 					s.first.start = null_timepoint;
-					s.second = Record(longestS, domainEnd);
+					s.second = TemporalRecord<T>(longestS, domainEnd);
 				}
 			}
 		}
 	}
 
 	// last step for last lead
-	for (Timestamp i = 0; i < m; i++)
+	for (T i = 0; i < m; i++)
 	{
 		if (r[i].start != null_timepoint)
 		{
-			for (Record* j = current_r[i]-1; j != end_r[i]; j++)
+			for (TemporalRecord<T>* j = current_r[i]-1; j != end_r[i]; j++)
 			{
 				if (s.second.start < s.second.end)
 					if ( (j->start < s.second.end) && (s.second.start < j->end) && (r[i].start != null_timepoint) && (s.second.end != null_timepoint) )
@@ -331,14 +338,15 @@ uint64_t dip_merge_anti( std::vector<dip_heap_node>& heap_r, Relation& S, Timest
 	return result;
 }
 
-uint64_t dip_anti(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd)
+template <typename T>
+uint64_t dip_anti(TemporalRelation<T>& R, TemporalRelation<T>& S, T& domainStart, T& domainEnd)
 {
 	#ifdef TIMES
 	Timer tim;
 	tim.start();
 	#endif
 
-	std::vector<dip_heap_node> heap_r;
+	std::vector<dip_heap_node<T>> heap_r;
 	create_dip( R, heap_r);
 
 	#ifdef TIMES
@@ -357,17 +365,18 @@ uint64_t dip_anti(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& d
 	return result;
 }
 
-uint64_t dip_merge_inner(std::vector<dip_heap_node>& heap_r, std::vector<Record>& S, Timestamp& domainStart, Timestamp& domainEnd)
+template <typename T>
+uint64_t dip_merge_inner(std::vector<dip_heap_node<T>>& heap_r, std::vector<TemporalRecord<T>>& S, T& domainStart, T& domainEnd)
 {
 	// DIPmerge variables and result (We consider that null timepoint is +INFINITY)
 	uint64_t result = 0;
-	const Timestamp null_timepoint = (0 - 1);
+	const T null_timepoint = (0 - 1);
 	const uint32_t m = heap_r.size();
 
 	// load r
-	Record** current_r = (Record**) malloc( m*sizeof(Record*) );
-	Record** end_r = (Record**) malloc( m*sizeof(Record*) );
-	Record* r = (Record*) malloc( m*sizeof(Record) );
+	TemporalRecord<T>** current_r = (TemporalRecord<T>**) malloc( m*sizeof(TemporalRecord<T>*) );
+	TemporalRecord<T>** end_r = (TemporalRecord<T>**) malloc( m*sizeof(TemporalRecord<T>*) );
+	TemporalRecord<T>* r = (TemporalRecord<T>*) malloc( m*sizeof(TemporalRecord<T>) );
 	bool* r_nulls = (bool*) malloc( m*sizeof(bool) );
 	for (uint32_t i = 0; i < m; i++)
 	{
@@ -380,19 +389,23 @@ uint64_t dip_merge_inner(std::vector<dip_heap_node>& heap_r, std::vector<Record>
 
 	// load s
 	// DIP considers domainStart = -INFINITY, so we need some extra cleaning before main loop
-	Record* current_s = &S[0];
-	const Record* end_s = &S[0] + S.size();
-	Record s;
+	TemporalRecord<T>* current_s = &S[0];
+	const TemporalRecord<T>* end_s = &S[0] + S.size();
+	TemporalRecord<T> s;
 	bool s_null = false;
 	// fetchRow(S)
 	s = *current_s++;
 
 	// main loop
-	Timestamp i = 0;
+	T i = 0;
 	while ( (r[i].start != null_timepoint) || (s.start != null_timepoint) )
 	{
 		if ( (r[i].start < s.end) && (s.start < r[i].end) ) // overlap check
-			result++;
+#ifdef WORKLOAD_COUNT
+			result += 1;
+#else
+			result += r[i].start ^ s.start;
+#endif
 
 		if ( (r[i].start != null_timepoint) && ( (s.start == null_timepoint) || (r[i].end <= s.end) ) )
 		{
@@ -438,16 +451,17 @@ uint64_t dip_merge_inner(std::vector<dip_heap_node>& heap_r, std::vector<Record>
 	return result;
 }
 
-uint64_t dip_inner(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd)
+template <typename T>
+uint64_t dip_inner(TemporalRelation<T>& R, TemporalRelation<T>& S, T& domainStart, T& domainEnd)
 {
 	#ifdef TIMES
 	Timer tim;
 	tim.start();
 	#endif
 
-	std::vector<dip_heap_node> heap_r;
+	std::vector<dip_heap_node<T>> heap_r;
 	create_dip( R, heap_r);
-	std::vector<dip_heap_node> heap_s;
+	std::vector<dip_heap_node<T>> heap_s;
 	create_dip( S, heap_s);
 
 	#ifdef TIMES
@@ -466,4 +480,11 @@ uint64_t dip_inner(Relation& R, Relation& S, Timestamp& domainStart, Timestamp&
 	#endif
 
 	return result;
-}
\ No newline at end of file
+}
+
+template uint64_t dip_anti<Timestamp>(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd);
+template uint64_t dip_anti<ShortTimestamp>(ShortRelation& R, ShortRelation& S, ShortTimestamp& domainStart, ShortTimestamp& domainEnd);
+template uint64_t o_dip_anti<Timestamp>(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd);
+template uint64_t o_dip_anti<ShortTimestamp>(ShortRelation& R, ShortRelation& S, ShortTimestamp& domainStart, ShortTimestamp& domainEnd);
+template uint64_t dip_inner<Timestamp>(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd);
+template uint64_t dip_inner<ShortTimestamp>(ShortRelation& R, ShortRelation& S, ShortTimestamp& domainStart, ShortTimestamp& domainEnd);
@@ -0,0 +1,129 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/relation.hpp"
+#include "../containers/timeline_index.hpp"
+
+////////////////////
+// Internal loops //
+////////////////////
+
+/* a tuple that starts overlaps with all active tuples of the other group */
+template <typename T>
+inline uint64_t ebi_report(T start, const TimelineActiveSet<T> &active)
+{
+#ifdef WORKLOAD_COUNT
+	return active.size;
+#else
+	uint64_t result = 0;
+	const T* starts = active.starts;
+	for (size_t i = 0; i < active.size; i++)
+		result += start ^ starts[i];
+	return result;
+#endif
+}
+
+
+//////////////////////////////
+// Single-thread processing //
+//////////////////////////////
+
+/*
+Endpoint-based plane sweep: sorts the endpoints of R and S in one stream, ends before starts at the same time,
+and keeps the active tuples of each group in a gapless set, so that each start joins with the active tuples of the other group.
+A zero-length tuple has a single point event between the ends and the starts of its time: it joins with the active tuples
+of the other group, which contain its point, and never becomes active.
+Tuples are numbered over R followed by S, so the tuple of an endpoint also tells its group
+*/
+template <typename T>
+uint64_t ebi_join(TemporalRelation<T> &R, TemporalRelation<T> &S)
+{
+	uint64_t result = 0;
+	TimelineEvent<T>* event_list = (TimelineEvent<T>*) malloc( 2 * (R.numRecords + S.numRecords) * sizeof(TimelineEvent<T>) );
+	size_t numEvents = 0;
+	for (size_t i = 0; i < R.numRecords; i++)
+	{
+		if (R.record_list[i].end <= R.record_list[i].start)
+		{
+			event_list[numEvents++] = TimelineEvent<T>( R.record_list[i].start, i, TIMELINE_POINT);
+			continue;
+		}
+		event_list[numEvents++] = TimelineEvent<T>( R.record_list[i].start, i, TIMELINE_START);
+		event_list[numEvents++] = TimelineEvent<T>( R.record_list[i].end, i, TIMELINE_END);
+	}
+	for (size_t i = 0; i < S.numRecords; i++)
+	{
+		if (S.record_list[i].end <= S.record_list[i].start)
+		{
+			event_list[numEvents++] = TimelineEvent<T>( S.record_list[i].start, R.numRecords + i, TIMELINE_POINT);
+			continue;
+		}
+		event_list[numEvents++] = TimelineEvent<T>( S.record_list[i].start, R.numRecords + i, TIMELINE_START);
+		event_list[numEvents++] = TimelineEvent<T>( S.record_list[i].end, R.numRecords + i, TIMELINE_END);
+	}
+	std::sort( event_list, event_list + numEvents);
+
+	TimelineActiveSet<T> activeR, activeS;
+	activeR.init( R.numRecords);
+	activeS.init( S.numRecords);
+	const Position firstS = R.numRecords;
+	for (TimelineEvent<T>* e = event_list; e != event_list + numEvents; e++)
+	{
+		Position tuple = e->code >> 2;
+		if ( (e->code & 3) == TIMELINE_END )
+		{
+			if (tuple < firstS)
+				activeR.erase( tuple);
+			else
+				activeS.erase( tuple - firstS);
+		}
+		else
+		{
+			if (tuple < firstS)
+			{
+				result += ebi_report( e->time, activeS);
+				if ( (e->code & 3) == TIMELINE_START )
+					activeR.insert( tuple, e->time);
+			}
+			else
+			{
+				result += ebi_report( e->time, activeR);
+				if ( (e->code & 3) == TIMELINE_START )
+					activeS.insert( tuple - firstS, e->time);
+			}
+		}
+	}
+
+	free( event_list );
+
+	return result;
+}
+
+template uint64_t ebi_join<Timestamp>(Relation &R, Relation &S);
+template uint64_t ebi_join<ShortTimestamp>(ShortRelation &R, ShortRelation &S);
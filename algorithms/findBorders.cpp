@@ -28,15 +28,16 @@
 
 #include "../containers/relation.hpp"
 #include "../containers/borders.hpp"
+#include "../containers/placement.hpp"
 
 /*
 helper function -
 for a range of [1,size], sets toTakeStart and toTakeEnd with equal subrange to be read, for thread with id chunk out of c total threads
 */
-void chunk_to_read(uint32_t size, uint32_t c, uint32_t chunk, uint32_t &toTakeStart, uint32_t &toTakeEnd)
+void chunk_to_read(Position size, uint32_t c, uint32_t chunk, Position &toTakeStart, Position &toTakeEnd)
 {
-	uint32_t divResult = size / c;
-	uint32_t modResult = size % c;
+	Position divResult = size / c;
+	Position modResult = size % c;
 	toTakeStart = 1;
 	for (uint32_t i=0; i < chunk; i++)
 	{
@@ -59,6 +60,7 @@ struct structForParallelFindBorders
 	ExtendedRelation *rel;			// relation to find its borders
 	BordersElement* borders;	// linked list for border information in each relation chunk
 	uint32_t *sizes;
+	uint32_t numBorders;			// number of groups found in relation
 };
 
 void* find_borders_count_size(void* args)
@@ -66,10 +68,8 @@ void* find_borders_count_size(void* args)
 	structForParallelFindBorders* gained = (structForParallelFindBorders*) args;
 
 	// find chunk to read from S
-	uint32_t toTakeStart, toTakeEnd;
+	Position toTakeStart, toTakeEnd;
 	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
-	--toTakeStart;
-	--toTakeEnd;
 
 	// to handle edge case at which R.size() < c
 	if (toTakeStart > toTakeEnd)
@@ -77,22 +77,22 @@ void* find_borders_count_size(void* args)
 		gained->sizes[ gained->chunk ] = 0;
 		return NULL;
 	}
+	--toTakeStart;
+	--toTakeEnd;
 
 	// find borders between [toTakeStart,toTakeEnd]
 	uint32_t local_size = 0;
 	if (
 		(gained->chunk == 0) ||
-		(gained->rel->record_list[toTakeStart].group1 != gained->rel->record_list[toTakeStart-1].group1) ||
-		(gained->rel->record_list[toTakeStart].group2 != gained->rel->record_list[toTakeStart-1].group2)
+		(gained->rel->record_list[toTakeStart].key != gained->rel->record_list[toTakeStart-1].key)
 	)
 	{
 		local_size++;
 	}
-	for (uint32_t i = toTakeStart+1; i <= toTakeEnd; i++)
+	for (Position i = toTakeStart+1; i <= toTakeEnd; i++)
 	{
 		if (
-			(gained->rel->record_list[i].group1 != gained->rel->record_list[i-1].group1) ||
-			(gained->rel->record_list[i].group2 != gained->rel->record_list[i-1].group2)
+			(gained->rel->record_list[i].key != gained->rel->record_list[i-1].key)
 		)
 		{
 			local_size++;
@@ -109,21 +109,20 @@ void* find_borders_set(void* args)
 	structForParallelFindBorders* gained = (structForParallelFindBorders*) args;
 
 	// find chunk to read from S
-	uint32_t toTakeStart, toTakeEnd;
+	Position toTakeStart, toTakeEnd;
 	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
-	--toTakeStart;
-	--toTakeEnd;
 
 	// to handle edge case at which R.size() < c
 	if (toTakeStart > toTakeEnd)
 		return NULL;
+	--toTakeStart;
+	--toTakeEnd;
 
 	// find borders between [toTakeStart,toTakeEnd]
 	uint32_t point_to_write = gained->sizes[gained->chunk];
 	if (
 		(gained->chunk == 0) ||
-		(gained->rel->record_list[toTakeStart].group1 != gained->rel->record_list[toTakeStart-1].group1) ||
-		(gained->rel->record_list[toTakeStart].group2 != gained->rel->record_list[toTakeStart-1].group2)
+		(gained->rel->record_list[toTakeStart].key != gained->rel->record_list[toTakeStart-1].key)
 	)
 	{
 		if (gained->chunk != 0)
@@ -131,22 +130,19 @@ void* find_borders_set(void* args)
 			gained->borders[ point_to_write-1 ].position_end = toTakeStart-1;
 		}
 
-		gained->borders[ point_to_write ].group1 = gained->rel->record_list[toTakeStart].group1;
-		gained->borders[ point_to_write ].group2 = gained->rel->record_list[toTakeStart].group2;
+		gained->borders[ point_to_write ].key = gained->rel->record_list[toTakeStart].key;
 		gained->borders[ point_to_write ].position_start = toTakeStart;
 		point_to_write++;
 	}
-	for (uint32_t i = toTakeStart+1; i <= toTakeEnd; i++)
+	for (Position i = toTakeStart+1; i <= toTakeEnd; i++)
 	{
 		if (
-			(gained->rel->record_list[i].group1 != gained->rel->record_list[i-1].group1) ||
-			(gained->rel->record_list[i].group2 != gained->rel->record_list[i-1].group2)
+			(gained->rel->record_list[i].key != gained->rel->record_list[i-1].key)
 		)
 		{
 			gained->borders[ point_to_write-1 ].position_end = i-1;
 
-			gained->borders[ point_to_write ].group1 = gained->rel->record_list[i].group1;
-			gained->borders[ point_to_write ].group2 = gained->rel->record_list[i].group2;
+			gained->borders[ point_to_write ].key = gained->rel->record_list[i].key;
 			gained->borders[ point_to_write ].position_start = i;
 			point_to_write++;
 		}
@@ -155,7 +151,41 @@ void* find_borders_set(void* args)
 	return NULL;
 }
 
-void mainBorders( ExtendedRelation& R, Borders& bordersR, ExtendedRelation& S, Borders& bordersS, uint32_t c)
+/*
+sets the zone map (minStart, maxStart, minEnd, maxEnd) and the sum of lengths of the groups of a chunk of borders
+*/
+void* find_borders_stats(void* args)
+{
+	structForParallelFindBorders* gained = (structForParallelFindBorders*) args;
+
+	// find chunk of groups to set
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->numBorders, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+	--toTakeStart;
+	--toTakeEnd;
+
+	for (uint32_t g = toTakeStart; g != toTakeEnd+1; g++)
+	{
+		BordersElement& b = gained->borders[g];
+
+		// groups are sorted by start point
+		b.minStart = gained->rel->record_list[b.position_start].start;
+		b.maxStart = gained->rel->record_list[b.position_end].start;
+		b.minEnd   = std::numeric_limits<Timestamp>::max();
+		b.maxEnd   = std::numeric_limits<Timestamp>::min();
+		b.sumLength = 0;
+		for (Position i = b.position_start; i <= b.position_end; i++)
+		{
+			b.minEnd = std::min(b.minEnd, gained->rel->record_list[i].end);
+			b.maxEnd = std::max(b.maxEnd, gained->rel->record_list[i].end);
+			b.sumLength += gained->rel->record_list[i].end - gained->rel->record_list[i].start;
+		}
+	}
+
+	return NULL;
+}
+
+void mainBorders( ExtendedRelation& R, Borders& bordersR, ExtendedRelation& S, Borders& bordersS, ThreadPlacement& placement, uint32_t c)
 {
 	#ifdef TIMES
 	Timer tim;
@@ -177,7 +207,7 @@ void mainBorders( ExtendedRelation& R, Borders& bordersR, ExtendedRelation& S, B
 		toPass[i].chunk = i;
 		toPass[i].rel = &R;
 		toPass[i].sizes = sizes;
-		pthread_create( &threads[i], NULL, find_borders_count_size, &toPass[i]);
+		pthread_create( &threads[i], placement.attr(i), find_borders_count_size, &toPass[i]);
 	}
 	previous_total = 0;
 	for (uint32_t i = 0; i < c; i++)
@@ -196,13 +226,26 @@ void mainBorders( ExtendedRelation& R, Borders& bordersR, ExtendedRelation& S, B
 		toPass[i].rel = &R;
 		toPass[i].borders = bordersR.borders_list;
 		toPass[i].sizes = sizes;
-		pthread_create( &threads[i], NULL, find_borders_set, &toPass[i]);
+		pthread_create( &threads[i], placement.attr(i), find_borders_set, &toPass[i]);
 	}
 	for (uint32_t i = 0; i < c; i++)
 	{
 		pthread_join( threads[i], NULL);
 	}
+	if (bordersR.numBorders != 0)
 	bordersR.borders_list[ bordersR.numBorders-1 ].position_end = R.numRecords-1;
+
+	// set zone map of each group in sorted R
+	for (uint32_t i = 0; i < c; i++)
+	{
+		toPass[i].borders = bordersR.borders_list;
+		toPass[i].numBorders = bordersR.numBorders;
+		pthread_create( &threads[i], placement.attr(i), find_borders_stats, &toPass[i]);
+	}
+	for (uint32_t i = 0; i < c; i++)
+	{
+		pthread_join( threads[i], NULL);
+	}
 	free(sizes);
 
 	// find borders of each group in sorted S
@@ -214,7 +257,7 @@ void mainBorders( ExtendedRelation& R, Borders& bordersR, ExtendedRelation& S, B
 		toPass[i].chunk = i;
 		toPass[i].rel = &S;
 		toPass[i].sizes = sizes;
-		pthread_create( &threads[i], NULL, find_borders_count_size, &toPass[i]);
+		pthread_create( &threads[i], placement.attr(i), find_borders_count_size, &toPass[i]);
 	}
 	previous_total = 0;
 	for (uint32_t i = 0; i < c; i++)
@@ -233,13 +276,26 @@ void mainBorders( ExtendedRelation& R, Borders& bordersR, ExtendedRelation& S, B
 		toPass[i].rel = &S;
 		toPass[i].borders = bordersS.borders_list;
 		toPass[i].sizes = sizes;
-		pthread_create( &threads[i], NULL, find_borders_set, &toPass[i]);
+		pthread_create( &threads[i], placement.attr(i), find_borders_set, &toPass[i]);
 	}
 	for (uint32_t i = 0; i < c; i++)
 	{
 		pthread_join( threads[i], NULL);
 	}
+	if (bordersS.numBorders != 0)
 	bordersS.borders_list[ bordersS.numBorders-1 ].position_end = S.numRecords-1;
+
+	// set zone map of each group in sorted S
+	for (uint32_t i = 0; i < c; i++)
+	{
+		toPass[i].borders = bordersS.borders_list;
+		toPass[i].numBorders = bordersS.numBorders;
+		pthread_create( &threads[i], placement.attr(i), find_borders_stats, &toPass[i]);
+	}
+	for (uint32_t i = 0; i < c; i++)
+	{
+		pthread_join( threads[i], NULL);
+	}
 	free(sizes);
 
 	#ifdef TIMES
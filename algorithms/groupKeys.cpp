@@ -0,0 +1,360 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/relation.hpp"
+#include "../containers/placement.hpp"
+
+// findBorders
+void chunk_to_read(Position size, uint32_t c, uint32_t chunk, Position &toTakeStart, Position &toTakeEnd);
+
+struct structForParallelPackKeys
+{
+	uint32_t c;				// number of threads
+	uint32_t chunk;				// thread id [0,c)
+	ExtendedRelation *rel;			// relation to pack its non-temporal values
+	uint32_t *maxes;			// max value of each key column, MAX_KEY_COLUMNS per thread
+	uint32_t *shifts;			// position of each key column in the packed key
+	uint32_t *widths;			// bits of each key column in the packed key
+	uint32_t column;			// string key column to encode
+	uint32_t *translation;			// global id of each local id of the column
+};
+
+void* encode_keys_set(void* args)
+{
+	structForParallelPackKeys* gained = (structForParallelPackKeys*) args;
+
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+
+	uint32_t numKeys = gained->rel->numKeys;
+	uint32_t* value = gained->rel->key_columns + gained->column;
+	for (Position i = toTakeStart-1; i < toTakeEnd; i++)
+		value[(size_t) i*numKeys] = gained->translation[ value[(size_t) i*numKeys] ];
+
+	return NULL;
+}
+
+void* pack_keys_find_max(void* args)
+{
+	structForParallelPackKeys* gained = (structForParallelPackKeys*) args;
+
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+
+	uint32_t numKeys = gained->rel->numKeys;
+	uint32_t* local_max = gained->maxes + gained->chunk*MAX_KEY_COLUMNS;
+	for (Position i = toTakeStart-1; i < toTakeEnd; i++)
+	{
+		for (uint32_t k = 0; k < numKeys; k++)
+			local_max[k] = std::max( local_max[k], gained->rel->key_columns[(size_t) i*numKeys + k]);
+	}
+
+	return NULL;
+}
+
+void* pack_keys_set(void* args)
+{
+	structForParallelPackKeys* gained = (structForParallelPackKeys*) args;
+
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+
+	uint32_t numKeys = gained->rel->numKeys;
+	for (Position i = toTakeStart-1; i < toTakeEnd; i++)
+	{
+		GroupKey key = 0;
+		for (uint32_t k = 0; k < numKeys; k++)
+		{
+			if (gained->widths[k] != 0)
+				key |= ((GroupKey) gained->rel->key_columns[(size_t) i*numKeys + k]) << gained->shifts[k];
+		}
+		gained->rel->record_list[i].key = key;
+	}
+
+	return NULL;
+}
+
+/*
+Encodes the string key columns of R and S with one dictionary shared by both relations, using c threads.
+Each loader gave local ids to the strings it read, here the strings of both relations are sorted and get dense global ids,
+so that encoded values keep the order of strings. Local ids are then replaced by global ids in parallel
+*/
+void mainEncodeKeys( ExtendedRelation& R, ExtendedRelation& S, ThreadPlacement& placement, uint32_t c)
+{
+	#ifdef TIMES
+	Timer tim;
+	tim.start();
+	#endif
+
+	ExtendedRelation* rels[2] = { &R, &S };
+	pthread_t threads[c];
+	structForParallelPackKeys toPass[c];
+	size_t dictionary_size = 0;
+
+	for (uint32_t k = 0; k < R.numKeys; k++)
+	{
+		if (!R.stringKeys[k])
+			continue;
+
+		// shared dictionary of column k
+		std::vector<std::string> dictionary;
+		dictionary.reserve( R.local_dictionary[k].size() + S.local_dictionary[k].size());
+		for (uint32_t r = 0; r < 2; r++)
+			for (auto& entry : rels[r]->local_dictionary[k])
+				dictionary.push_back( entry.first);
+		std::sort( dictionary.begin(), dictionary.end());
+		dictionary.erase( std::unique( dictionary.begin(), dictionary.end()), dictionary.end());
+		dictionary_size += dictionary.size();
+
+		for (uint32_t r = 0; r < 2; r++)
+		{
+			// translate local ids of relation r to global ids
+			uint32_t* translation = (uint32_t*) malloc( rels[r]->local_dictionary[k].size()*sizeof(uint32_t) );
+			for (auto& entry : rels[r]->local_dictionary[k])
+				translation[entry.second] = std::lower_bound( dictionary.begin(), dictionary.end(), entry.first) - dictionary.begin();
+
+			for (uint32_t i = 0; i < c; i++)
+			{
+				toPass[i].c = c;
+				toPass[i].chunk = i;
+				toPass[i].rel = rels[r];
+				toPass[i].column = k;
+				toPass[i].translation = translation;
+				pthread_create( &threads[i], placement.attr(i), encode_keys_set, &toPass[i]);
+			}
+			for (uint32_t i = 0; i < c; i++)
+			{
+				pthread_join( threads[i], NULL);
+			}
+
+			free( translation );
+			std::unordered_map<std::string, uint32_t>().swap( rels[r]->local_dictionary[k] );
+		}
+	}
+
+	#ifdef TIMES
+	double timeEncodeKeys = tim.stop();
+	std::cout << "EncodeKeys time: " << timeEncodeKeys << " and dictionary size " << dictionary_size << std::endl;
+	#endif
+}
+
+/*
+helper function -
+finds the max value of each key column in rel, using c threads
+*/
+void find_key_max( ExtendedRelation& rel, uint32_t* maxes, ThreadPlacement& placement, uint32_t c)
+{
+	pthread_t threads[c];
+	structForParallelPackKeys toPass[c];
+	uint32_t* local_maxes = (uint32_t*) calloc( c*MAX_KEY_COLUMNS, sizeof(uint32_t) );
+
+	for (uint32_t i = 0; i < c; i++)
+	{
+		toPass[i].c = c;
+		toPass[i].chunk = i;
+		toPass[i].rel = &rel;
+		toPass[i].maxes = local_maxes;
+		pthread_create( &threads[i], placement.attr(i), pack_keys_find_max, &toPass[i]);
+	}
+	for (uint32_t i = 0; i < c; i++)
+	{
+		pthread_join( threads[i], NULL);
+		for (uint32_t k = 0; k < rel.numKeys; k++)
+			maxes[k] = std::max( maxes[k], local_maxes[i*MAX_KEY_COLUMNS + k]);
+	}
+
+	free( local_maxes );
+}
+
+/*
+helper function -
+replaces the values of key column k in both relations by their rank among the distinct values of the column.
+Ranks keep the order of values, so they can be packed in place of the values
+*/
+void rank_key_column( ExtendedRelation& R, ExtendedRelation& S, uint32_t k, uint32_t& max)
+{
+	std::vector<uint32_t> values;
+	values.reserve( R.numRecords + S.numRecords);
+	for (size_t i = 0; i < R.numRecords; i++)
+		values.push_back( R.key_columns[i*R.numKeys + k]);
+	for (size_t i = 0; i < S.numRecords; i++)
+		values.push_back( S.key_columns[i*S.numKeys + k]);
+	std::sort( values.begin(), values.end());
+	values.erase( std::unique( values.begin(), values.end()), values.end());
+
+	for (size_t i = 0; i < R.numRecords; i++)
+		R.key_columns[i*R.numKeys + k] = std::lower_bound( values.begin(), values.end(), R.key_columns[i*R.numKeys + k]) - values.begin();
+	for (size_t i = 0; i < S.numRecords; i++)
+		S.key_columns[i*S.numKeys + k] = std::lower_bound( values.begin(), values.end(), S.key_columns[i*S.numKeys + k]) - values.begin();
+
+	max = values.empty() ? 0 : values.size() - 1;
+}
+
+/* orders tuples of non-temporal values, numKeys values each, by their values one by one */
+struct KeyTupleOrder
+{
+	uint32_t numKeys;
+
+	bool operator () (const uint32_t* a, const uint32_t* b) const
+	{
+		return std::lexicographical_compare( a, a + this->numKeys, b, b + this->numKeys);
+	}
+};
+
+/*
+helper function -
+sets the key of each tuple of R and S to the rank of its non-temporal values among the distinct tuples of values of both relations.
+Ranks keep the order of the values compared one by one, and there are at most as many as tuples, so they always fit in a GroupKey.
+Returns the max rank
+*/
+GroupKey rank_key_tuples( ExtendedRelation& R, ExtendedRelation& S)
+{
+	uint32_t numKeys = R.numKeys;
+	std::vector<const uint32_t*> values;
+	values.reserve( R.numRecords + S.numRecords);
+	for (size_t i = 0; i < R.numRecords; i++)
+		values.push_back( R.key_columns + i*numKeys);
+	for (size_t i = 0; i < S.numRecords; i++)
+		values.push_back( S.key_columns + i*numKeys);
+	KeyTupleOrder order;
+	order.numKeys = numKeys;
+	std::sort( values.begin(), values.end(), order);
+
+	// values of R and S are apart, so each pointer tells the relation and the position of its tuple
+	const uint32_t* endOfR = R.key_columns + R.numRecords*numKeys;
+	GroupKey rank = 0;
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		if ( (i > 0) && order(values[i-1], values[i]) )
+			rank++;
+		if ( (values[i] >= R.key_columns) && (values[i] < endOfR) )
+			R.record_list[ (values[i] - R.key_columns) / numKeys ].key = rank;
+		else
+			S.record_list[ (values[i] - S.key_columns) / numKeys ].key = rank;
+	}
+
+	return rank;
+}
+
+/* bits needed to store values in [0,max] */
+uint32_t bits_for(uint32_t max)
+{
+	uint32_t bits = 0;
+	while ( (bits < 32) && ((((uint64_t) 1) << bits) <= max) )
+		bits++;
+	return bits;
+}
+
+/*
+Packs the non-temporal values of R and S to a GroupKey, using c threads.
+Each key column takes as many bits as its max value in both relations needs, first column at the most significant bits,
+so comparing packed keys is the same as comparing the non-temporal values one by one.
+If the columns don't fit in 64 bits, they are first replaced by their rank among distinct values,
+and if they still don't fit, each distinct tuple of values is replaced by its rank
+*/
+void mainPackKeys( ExtendedRelation& R, ExtendedRelation& S, ThreadPlacement& placement, uint32_t c)
+{
+	#ifdef TIMES
+	Timer tim;
+	tim.start();
+	#endif
+
+	uint32_t numKeys = R.numKeys;
+	uint32_t maxes[MAX_KEY_COLUMNS] = {0};
+	uint32_t widths[MAX_KEY_COLUMNS];
+	uint32_t shifts[MAX_KEY_COLUMNS];
+	uint32_t total_width = 0;
+
+	// find bits needed by each column in both relations
+	find_key_max( R, maxes, placement, c);
+	find_key_max( S, maxes, placement, c);
+	for (uint32_t k = 0; k < numKeys; k++)
+	{
+		widths[k] = bits_for( maxes[k]);
+		total_width += widths[k];
+	}
+	if (total_width > 64)
+	{
+		total_width = 0;
+		for (uint32_t k = 0; k < numKeys; k++)
+		{
+			rank_key_column( R, S, k, maxes[k]);
+			widths[k] = bits_for( maxes[k]);
+			total_width += widths[k];
+		}
+	}
+
+	ExtendedRelation* rels[2] = { &R, &S };
+	if (total_width > 64)
+	{
+		GroupKey maxRank = rank_key_tuples( R, S);
+		total_width = 0;
+		while ( (total_width < 64) && ((maxRank >> total_width) != 0) )
+			total_width++;
+	}
+	else
+	{
+		uint32_t shift = total_width;
+		for (uint32_t k = 0; k < numKeys; k++)
+		{
+			shift -= widths[k];
+			shifts[k] = shift;
+		}
+
+		// pack keys of both relations
+		pthread_t threads[c];
+		structForParallelPackKeys toPass[c];
+		for (uint32_t r = 0; r < 2; r++)
+		{
+			for (uint32_t i = 0; i < c; i++)
+			{
+				toPass[i].c = c;
+				toPass[i].chunk = i;
+				toPass[i].rel = rels[r];
+				toPass[i].shifts = shifts;
+				toPass[i].widths = widths;
+				pthread_create( &threads[i], placement.attr(i), pack_keys_set, &toPass[i]);
+			}
+			for (uint32_t i = 0; i < c; i++)
+			{
+				pthread_join( threads[i], NULL);
+			}
+		}
+	}
+	for (uint32_t r = 0; r < 2; r++)
+	{
+		large_free( rels[r]->key_columns );
+		rels[r]->key_columns = NULL;
+	}
+
+	#ifdef TIMES
+	double timePackKeys = tim.stop();
+	std::cout << "PackKeys time: " << timePackKeys << " and key width " << total_width << " bits" << std::endl;
+	#endif
+}
@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/relation.hpp"
+#include "../containers/hint_index.hpp"
+
+////////////////////
+// Internal loops //
+////////////////////
+
+/* all tuples of [first,last) overlap with r */
+template <typename T>
+inline uint64_t hint_report_all(const TemporalRecord<T>* r, const TemporalRecord<T>* first, const TemporalRecord<T>* last)
+{
+#ifdef WORKLOAD_COUNT
+	return last - first;
+#else
+	uint64_t result = 0;
+	for (const TemporalRecord<T>* s = first; s != last; s++)
+		result += r->start ^ s->start;
+	return result;
+#endif
+}
+
+/* tuples of [first,last) start before the end of r, overlap if they end after its start */
+template <typename T>
+inline uint64_t hint_report_end_after(const TemporalRecord<T>* r, const TemporalRecord<T>* first, const TemporalRecord<T>* last)
+{
+	uint64_t result = 0;
+	for (const TemporalRecord<T>* s = first; s != last; s++)
+	{
+		if (s->end > r->start)
+#ifdef WORKLOAD_COUNT
+			result += 1;
+#else
+			result += r->start ^ s->start;
+#endif
+	}
+	return result;
+}
+
+/* tuples of [first,last), sorted by start point, end after the start of r, overlap if they start before its end */
+template <typename T>
+inline uint64_t hint_report_start_before(const TemporalRecord<T>* r, const TemporalRecord<T>* first, const TemporalRecord<T>* last)
+{
+	uint64_t result = 0;
+	for (const TemporalRecord<T>* s = first; (s != last) && (s->start < r->end); s++)
+	{
+#ifdef WORKLOAD_COUNT
+		result += 1;
+#else
+		result += r->start ^ s->start;
+#endif
+	}
+	return result;
+}
+
+/* tuples of [first,last), sorted by start point, overlap with r if they start before its end and end after its start */
+template <typename T>
+inline uint64_t hint_report_overlap(const TemporalRecord<T>* r, const TemporalRecord<T>* first, const TemporalRecord<T>* last)
+{
+	uint64_t result = 0;
+	for (const TemporalRecord<T>* s = first; (s != last) && (s->start < r->end); s++)
+	{
+		if (s->end > r->start)
+#ifdef WORKLOAD_COUNT
+			result += 1;
+#else
+			result += r->start ^ s->start;
+#endif
+	}
+	return result;
+}
+
+
+//////////////////////////////
+// Single-thread processing //
+//////////////////////////////
+
+/*
+Joins each tuple of R with the tuples of S indexed in HS.
+At each level, a tuple of R is compared only with the first (pa) and last (pb) partition it covers:
+replicas are reported only from pa, where they contain the start of r, and originals from pa to pb, so each pair is found once
+*/
+template <typename T>
+uint64_t hint_join(TemporalRelation<T> &R, TemporalHintIndex<T> &HS)
+{
+	uint64_t result = 0;
+	if (HS.numRecords == 0)
+		return 0;
+
+	const TemporalRecord<T>* S = HS.record_list;
+	const size_t* offsets = HS.offsets;
+	TemporalRecord<T>* lastR = R.record_list + R.numRecords;
+	for (TemporalRecord<T>* r = R.record_list; r != lastR; r++)
+	{
+		// r covers [start,end-1], or the cell of its start if zero-length - cells out of the domain of HS are clamped to its first and last cell
+		if ( (r->end <= HS.base) || (r->start > HS.last) )
+			continue;
+		T lastCovered = (r->end > r->start) ? (T) (r->end - 1) : r->start;
+		uint64_t a = (r->start < HS.base) ? 0 : ((uint64_t) (r->start - HS.base)) >> HS.shift;
+		uint64_t b = ((uint64_t) (std::min(lastCovered, HS.last) - HS.base)) >> HS.shift;
+
+		for (uint32_t l = HS.numBits, k = 0; ; l--, k++)
+		{
+			uint64_t pa = a >> k;
+			uint64_t pb = b >> k;
+			size_t o = HS.offset(l, false, pa, HINT_IN);
+			size_t p = HS.offset(l, true, pa, HINT_IN);
+
+			if (pa == pb)
+			{
+				result += hint_report_overlap( r, S + offsets[o], S + offsets[o+1]);
+				result += hint_report_start_before( r, S + offsets[o+1], S + offsets[o+2]);
+				result += hint_report_end_after( r, S + offsets[p], S + offsets[p+1]);
+				result += hint_report_all( r, S + offsets[p+1], S + offsets[p+2]);
+			}
+			else
+			{
+				// first partition, then originals of the partitions in between without comparisons, then last partition
+				size_t q = HS.offset(l, false, pb, HINT_IN);
+				result += hint_report_end_after( r, S + offsets[o], S + offsets[o+1]);
+				result += hint_report_all( r, S + offsets[o+1], S + offsets[q]);
+				result += hint_report_end_after( r, S + offsets[p], S + offsets[p+1]);
+				result += hint_report_all( r, S + offsets[p+1], S + offsets[p+2]);
+				result += hint_report_start_before( r, S + offsets[q], S + offsets[q+1]);
+				result += hint_report_start_before( r, S + offsets[q+1], S + offsets[q+2]);
+			}
+
+			if (l == 0)
+				break;
+		}
+	}
+
+	return result;
+}
+
+template uint64_t hint_join<Timestamp>(Relation &R, HintIndex &HS);
+template uint64_t hint_join<ShortTimestamp>(ShortRelation &R, TemporalHintIndex<ShortTimestamp> &HS);
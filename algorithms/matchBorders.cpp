@@ -0,0 +1,253 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/borders.hpp"
+#include "../containers/group_directory.hpp"
+#include "../containers/placement.hpp"
+
+// findBorders
+void chunk_to_read(Position size, uint32_t c, uint32_t chunk, Position &toTakeStart, Position &toTakeEnd);
+
+/* ratio of groups between the two relations above which the merge gallops over the bigger one */
+#define GALLOPING_SKEW 16
+
+struct structForParallelMatchBorders
+{
+	uint32_t c;				// number of threads
+	uint32_t chunk;				// thread id [0,c)
+	Borders* bordersR;			// borders of relation R, split in c equal ranges of groups
+	Borders* bordersS;			// borders of relation S, range aligned to the range of bordersR
+	GroupPair* pairs;			// array to save matched groups, NULL while counting
+	uint32_t *sizes;
+};
+
+/*
+helper function -
+returns the first group of borders that is not less than key, using binary search in [from,borders.numBorders)
+*/
+uint32_t lower_bound_group(Borders& borders, uint32_t from, const BordersElement& key)
+{
+	return std::lower_bound( borders.borders_list + from, borders.borders_list + borders.numBorders, key, groupLess) - borders.borders_list;
+}
+
+/*
+helper function -
+returns the first group of borders that is not less than key, using galloping search from position from.
+Distance to the result is doubled until it is bracketed, so the cost is logarithmic to the number of skipped groups
+*/
+uint32_t gallop_group(Borders& borders, uint32_t from, const BordersElement& key)
+{
+	uint32_t bound = 1;
+	uint32_t last = borders.numBorders;
+
+	while ( (from + bound < last) && groupLess(borders.borders_list[from + bound], key) )
+		bound *= 2;
+
+	uint32_t low = from + bound/2;
+	uint32_t high = std::min( from + bound + 1, last);
+	return std::lower_bound( borders.borders_list + low, borders.borders_list + high, key, groupLess) - borders.borders_list;
+}
+
+/*
+helper function -
+merges the range of bordersR given to the current thread with the aligned range of bordersS.
+Pairs are written only if gained->pairs is set, otherwise they are only counted
+*/
+uint32_t match_borders_range(structForParallelMatchBorders* gained)
+{
+	// find chunk to read from bordersR
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->bordersR->numBorders, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+	--toTakeStart;
+	--toTakeEnd;
+
+	uint32_t curr_r = toTakeStart;
+	uint32_t last_r = toTakeEnd + 1;
+
+	// to handle edge case at which bordersR.numBorders < c
+	if (curr_r == last_r)
+		return 0;
+
+	// S groups before the first R group of the chunk can't match, so start from its lower bound
+	BordersElement* bR = gained->bordersR->borders_list;
+	BordersElement* bS = gained->bordersS->borders_list;
+	uint32_t curr_s = lower_bound_group( *(gained->bordersS), 0, bR[curr_r]);
+	uint32_t last_s = gained->bordersS->numBorders;
+
+	// when one relation has far more groups, skip its unmatched groups by galloping instead of one at a time
+	bool gallopS = ( (uint64_t) gained->bordersS->numBorders >= (uint64_t) GALLOPING_SKEW * gained->bordersR->numBorders );
+	bool gallopR = ( (uint64_t) gained->bordersR->numBorders >= (uint64_t) GALLOPING_SKEW * gained->bordersS->numBorders );
+
+	uint32_t point_to_write = (gained->pairs == NULL) ? 0 : gained->sizes[gained->chunk];
+	uint32_t count = 0;
+	while ( (curr_r != last_r) && (curr_s != last_s) )
+	{
+		if ( groupLess(bR[curr_r], bS[curr_s]) )
+		{
+			if (gallopR)
+				curr_r = std::min( gallop_group( *(gained->bordersR), curr_r+1, bS[curr_s]), last_r);
+			else
+				curr_r++;
+		}
+		else if ( groupLess(bS[curr_s], bR[curr_r]) )
+		{
+			if (gallopS)
+				curr_s = gallop_group( *(gained->bordersS), curr_s+1, bR[curr_r]);
+			else
+				curr_s++;
+		}
+		else
+		{
+			if (gained->pairs != NULL)
+				gained->pairs[point_to_write + count] = GroupPair(curr_r, curr_s);
+			count++;
+
+			curr_r++;
+			curr_s++;
+		}
+	}
+
+	return count;
+}
+
+void* match_borders_count_size(void* args)
+{
+	structForParallelMatchBorders* gained = (structForParallelMatchBorders*) args;
+
+	gained->sizes[ gained->chunk ] = match_borders_range(gained);
+
+	return NULL;
+}
+
+void* match_borders_set(void* args)
+{
+	structForParallelMatchBorders* gained = (structForParallelMatchBorders*) args;
+
+	match_borders_range(gained);
+
+	return NULL;
+}
+
+/*
+Matches the groups of bordersR with the groups of bordersS, using c threads.
+bordersR is split in c equal ranges of groups and each thread merges its range with bordersS,
+starting from a position of bordersS found by binary search.
+pairs is ordered as bordersR
+*/
+void mainMatchBorders( Borders& bordersR, Borders& bordersS, GroupPairs& pairs, ThreadPlacement& placement, uint32_t c)
+{
+	#ifdef TIMES
+	Timer tim;
+	tim.start();
+	#endif
+
+	uint32_t total_size, previous_total;
+	pthread_t threads[c];
+	structForParallelMatchBorders toPass[c];
+	uint32_t *sizes = (uint32_t*) malloc( c*sizeof(uint32_t) );
+
+	// count matched groups of each range
+	for (uint32_t i = 0; i < c; i++)
+	{
+		toPass[i].c = c;
+		toPass[i].chunk = i;
+		toPass[i].bordersR = &bordersR;
+		toPass[i].bordersS = &bordersS;
+		toPass[i].pairs = NULL;
+		toPass[i].sizes = sizes;
+		pthread_create( &threads[i], placement.attr(i), match_borders_count_size, &toPass[i]);
+	}
+	total_size = 0;
+	previous_total = 0;
+	for (uint32_t i = 0; i < c; i++)
+	{
+		pthread_join( threads[i], NULL);
+		total_size += sizes[i];
+		sizes[i] = previous_total;
+		previous_total = total_size;
+	}
+
+	// set matched groups of each range
+	pairs.pairs_list = (GroupPair*) malloc( total_size*sizeof(GroupPair) );
+	pairs.numPairs = total_size;
+	for (uint32_t i = 0; i < c; i++)
+	{
+		toPass[i].pairs = pairs.pairs_list;
+		pthread_create( &threads[i], placement.attr(i), match_borders_set, &toPass[i]);
+	}
+	for (uint32_t i = 0; i < c; i++)
+	{
+		pthread_join( threads[i], NULL);
+	}
+	free(sizes);
+
+	#ifdef TIMES
+	double timeMatchBorders = tim.stop();
+	std::cout << "MatchBorders time: " << timeMatchBorders << std::endl;
+	#endif
+}
+
+/*
+Builds the directory of groups that exist in both R and S, using c threads for matching
+*/
+void mainGroupDirectory( Borders& bordersR, Borders& bordersS, GroupDirectory& directory, ThreadPlacement& placement, uint32_t c)
+{
+	GroupPairs pairs;
+	mainMatchBorders( bordersR, bordersS, pairs, placement, c);
+
+	#ifdef TIMES
+	Timer tim;
+	tim.start();
+	#endif
+
+	directory.numGroups = pairs.numPairs;
+	directory.keys = (GroupKey*) malloc( pairs.numPairs*sizeof(GroupKey) );
+	directory.groupR = (uint32_t*) malloc( pairs.numPairs*sizeof(uint32_t) );
+	directory.groupS = (uint32_t*) malloc( pairs.numPairs*sizeof(uint32_t) );
+	directory.numBordersR = bordersR.numBorders;
+	directory.numBordersS = bordersS.numBorders;
+	directory.denseR = (uint32_t*) malloc( bordersR.numBorders*sizeof(uint32_t) );
+	directory.denseS = (uint32_t*) malloc( bordersS.numBorders*sizeof(uint32_t) );
+	std::fill( directory.denseR, directory.denseR + bordersR.numBorders, NO_MATCH);
+	std::fill( directory.denseS, directory.denseS + bordersS.numBorders, NO_MATCH);
+
+	for (uint32_t g = 0; g < pairs.numPairs; g++)
+	{
+		directory.keys[g] = bordersR.borders_list[ pairs.pairs_list[g].r ].key;
+		directory.groupR[g] = pairs.pairs_list[g].r;
+		directory.groupS[g] = pairs.pairs_list[g].s;
+		directory.denseR[ pairs.pairs_list[g].r ] = g;
+		directory.denseS[ pairs.pairs_list[g].s ] = g;
+	}
+
+	#ifdef TIMES
+	double timeGroupDirectory = tim.stop();
+	std::cout << "GroupDirectory time: " << timeGroupDirectory << " and groups " << directory.numGroups << std::endl;
+	#endif
+}
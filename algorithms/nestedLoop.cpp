@@ -0,0 +1,126 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/relation.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/* tuples of S compared at a time with each tuple of R */
+#define NESTED_LOOP_BLOCK 64
+
+//////////////////////////////
+// Single-thread processing //
+//////////////////////////////
+
+/*
+Compares all pairs of R and S, without building anything.
+S is copied in blocks to arrays of starts and ends widened to 64 bits, and each tuple of R is compared with a whole block,
+four tuples of S at a time with AVX2, without branches: a pair adds its checksum masked by the overlap check.
+Blocks are padded with tuples that overlap nothing
+*/
+template <typename T>
+uint64_t nested_loop(TemporalRelation<T> &R, TemporalRelation<T> &S)
+{
+	uint64_t result = 0;
+	alignas(32) uint64_t starts[NESTED_LOOP_BLOCK];
+	alignas(32) uint64_t ends[NESTED_LOOP_BLOCK];
+	const TemporalRecord<T>* lastR = R.record_list + R.numRecords;
+
+#ifdef __AVX2__
+	// vector compares are signed, so both sides of a compare have their top bit flipped
+	const __m256i sign = _mm256_set1_epi64x( (long long) 0x8000000000000000ULL );
+	__m256i sum = _mm256_setzero_si256();
+#endif
+
+	for (size_t first = 0; first < S.numRecords; first += NESTED_LOOP_BLOCK)
+	{
+		size_t size = std::min( S.numRecords - first, (size_t) NESTED_LOOP_BLOCK);
+		size_t padded = (size + 3) & ~((size_t) 3);
+		for (size_t i = 0; i < size; i++)
+		{
+			starts[i] = S.record_list[first + i].start;
+			ends[i] = S.record_list[first + i].end;
+		}
+		for (size_t i = size; i < padded; i++)
+		{
+			starts[i] = ~((uint64_t) 0);
+			ends[i] = 0;
+		}
+
+		for (const TemporalRecord<T>* r = R.record_list; r != lastR; r++)
+		{
+#ifdef __AVX2__
+			const __m256i start = _mm256_set1_epi64x( (long long) r->start );
+			const __m256i startFlipped = _mm256_xor_si256( start, sign);
+			const __m256i endFlipped = _mm256_xor_si256( _mm256_set1_epi64x( (long long) r->end ), sign);
+			for (size_t i = 0; i < padded; i += 4)
+			{
+				__m256i sStart = _mm256_load_si256( (const __m256i*) (starts + i) );
+				__m256i sEnd = _mm256_load_si256( (const __m256i*) (ends + i) );
+
+				// r.start < s.end && s.start < r.end
+				__m256i overlap = _mm256_and_si256( _mm256_cmpgt_epi64( _mm256_xor_si256( sEnd, sign), startFlipped),
+													_mm256_cmpgt_epi64( endFlipped, _mm256_xor_si256( sStart, sign)) );
+#ifdef WORKLOAD_COUNT
+				sum = _mm256_sub_epi64( sum, overlap);
+#else
+				sum = _mm256_add_epi64( sum, _mm256_and_si256( _mm256_xor_si256( start, sStart), overlap) );
+#endif
+			}
+#else
+			const uint64_t start = r->start;
+			const uint64_t end = r->end;
+			uint64_t partial = 0;
+			for (size_t i = 0; i < padded; i++)
+			{
+				uint64_t overlap = (start < ends[i]) & (starts[i] < end);
+#ifdef WORKLOAD_COUNT
+				partial += overlap;
+#else
+				partial += (start ^ starts[i]) & (0 - overlap);
+#endif
+			}
+			result += partial;
+#endif
+		}
+	}
+
+#ifdef __AVX2__
+	alignas(32) uint64_t lanes[4];
+	_mm256_store_si256( (__m256i*) lanes, sum);
+	result += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+	return result;
+}
+
+template uint64_t nested_loop<Timestamp>(Relation &R, Relation &S);
+template uint64_t nested_loop<ShortTimestamp>(ShortRelation &R, ShortRelation &S);
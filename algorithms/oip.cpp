@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/relation.hpp"
+#include "../containers/oip_grid.hpp"
+
+////////////////////
+// Internal loops //
+////////////////////
+
+/* all pairs of two partitions overlap */
+template <typename T>
+inline uint64_t oip_all_pairs(const TemporalRecord<T>* firstR, const TemporalRecord<T>* lastR, const TemporalRecord<T>* firstS, const TemporalRecord<T>* lastS)
+{
+#ifdef WORKLOAD_COUNT
+	return (uint64_t) (lastR - firstR) * (lastS - firstS);
+#else
+	uint64_t result = 0;
+	for (const TemporalRecord<T>* r = firstR; r != lastR; r++)
+		for (const TemporalRecord<T>* s = firstS; s != lastS; s++)
+			result += r->start ^ s->start;
+	return result;
+#endif
+}
+
+/* pairs of two partitions that overlap */
+template <typename T>
+inline uint64_t oip_compare_pairs(const TemporalRecord<T>* firstR, const TemporalRecord<T>* lastR, const TemporalRecord<T>* firstS, const TemporalRecord<T>* lastS)
+{
+	uint64_t result = 0;
+	for (const TemporalRecord<T>* r = firstR; r != lastR; r++)
+	{
+		for (const TemporalRecord<T>* s = firstS; s != lastS; s++)
+		{
+			if ( (r->start < s->end) && (s->start < r->end) )
+#ifdef WORKLOAD_COUNT
+				result += 1;
+#else
+				result += r->start ^ s->start;
+#endif
+		}
+	}
+	return result;
+}
+
+
+//////////////////////////////
+// Single-thread processing //
+//////////////////////////////
+
+/*
+Joins the partitions of GR with the partitions of GS they can overlap with - both grids over the same granules.
+Partitions of GR are split in numParts parts, so that a group can be joined by many threads - only part part is joined here
+*/
+template <typename T>
+uint64_t oip_join(TemporalOipGrid<T> &GR, TemporalOipGrid<T> &GS, uint32_t part, uint32_t numParts)
+{
+	uint64_t result = 0;
+	uint32_t k = GR.numGranules;
+
+	for (size_t x = part; x < GR.partitions.size(); x += numParts)
+	{
+		uint32_t pr = GR.partitions[x];
+		uint32_t i = pr / k, j = pr % k;
+		const TemporalRecord<T>* firstR = GR.record_list + GR.offsets[pr];
+		const TemporalRecord<T>* lastR = GR.record_list + GR.offsets[pr+1];
+
+		// partitions of GS start in granules [0,j] - stop at the first one that starts after j
+		for (size_t y = 0; y < GS.partitions.size(); y++)
+		{
+			uint32_t ps = GS.partitions[y];
+			uint32_t a = ps / k, b = ps % k;
+			if (a > j)
+				break;
+			if (b < i)
+				continue;
+
+			const TemporalRecord<T>* firstS = GS.record_list + GS.offsets[ps];
+			const TemporalRecord<T>* lastS = GS.record_list + GS.offsets[ps+1];
+			if (std::max(i, a) + 1 < std::min(j, b))
+				result += oip_all_pairs( firstR, lastR, firstS, lastS);
+			else
+				result += oip_compare_pairs( firstR, lastR, firstS, lastS);
+		}
+	}
+
+	return result;
+}
+
+template uint64_t oip_join<Timestamp>(OipGrid &GR, OipGrid &GS, uint32_t part, uint32_t numParts);
+template uint64_t oip_join<ShortTimestamp>(TemporalOipGrid<ShortTimestamp> &GR, TemporalOipGrid<ShortTimestamp> &GS, uint32_t part, uint32_t numParts);
@@ -0,0 +1,185 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/relation.hpp"
+#include "../containers/key_filter.hpp"
+#include "../containers/placement.hpp"
+
+// findBorders
+void chunk_to_read(Position size, uint32_t c, uint32_t chunk, Position &toTakeStart, Position &toTakeEnd);
+
+struct structForParallelSemiJoin
+{
+	uint32_t c;				// number of threads
+	uint32_t chunk;				// thread id [0,c)
+	ExtendedRelation *rel;			// relation to read (keys to insert or tuples to filter)
+	KeyFilter *filter;			// keys of the other relation
+	ExtendedRecord* reduced;		// place to save tuples that pass the filter
+	Position *sizes;			// tuples kept by each thread
+};
+
+void* semi_join_build(void* args)
+{
+	structForParallelSemiJoin* gained = (structForParallelSemiJoin*) args;
+
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+
+	for (Position i = toTakeStart-1; i < toTakeEnd; i++)
+		gained->filter->insert( gained->rel->record_list[i].key);
+
+	return NULL;
+}
+
+void* semi_join_count_size(void* args)
+{
+	structForParallelSemiJoin* gained = (structForParallelSemiJoin*) args;
+
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+
+	Position local_size = 0;
+	for (Position i = toTakeStart-1; i < toTakeEnd; i++)
+	{
+		if ( gained->filter->contains( gained->rel->record_list[i].key) )
+			local_size++;
+	}
+
+	gained->sizes[ gained->chunk ] = local_size;
+
+	return NULL;
+}
+
+void* semi_join_set(void* args)
+{
+	structForParallelSemiJoin* gained = (structForParallelSemiJoin*) args;
+
+	Position toTakeStart, toTakeEnd;
+	chunk_to_read( gained->rel->numRecords, gained->c, gained->chunk, toTakeStart, toTakeEnd);
+
+	Position point_to_write = gained->sizes[ gained->chunk ];
+	for (Position i = toTakeStart-1; i < toTakeEnd; i++)
+	{
+		if ( gained->filter->contains( gained->rel->record_list[i].key) )
+			gained->reduced[ point_to_write++ ] = gained->rel->record_list[i];
+	}
+
+	return NULL;
+}
+
+/*
+helper function -
+drops the tuples of R whose non-temporal values don't exist in S.
+minStart and maxEnd of R are kept as they were, since they define the time domain of the join
+*/
+void reduce_relation( ExtendedRelation& R, ExtendedRelation& S, ThreadPlacement& placement, uint32_t c)
+{
+	pthread_t threads[c];
+	structForParallelSemiJoin toPass[c];
+	Position *sizes = (Position*) malloc( c*sizeof(Position) );
+	Position total_size, previous_total;
+
+	// insert keys of S
+	KeyFilter filter;
+	filter.init( S.numRecords);
+	for (uint32_t i = 0; i < c; i++)
+	{
+		toPass[i].c = c;
+		toPass[i].chunk = i;
+		toPass[i].rel = &S;
+		toPass[i].filter = &filter;
+		toPass[i].sizes = sizes;
+		pthread_create( &threads[i], placement.attr(i), semi_join_build, &toPass[i]);
+	}
+	for (uint32_t i = 0; i < c; i++)
+	{
+		pthread_join( threads[i], NULL);
+	}
+
+	// count tuples of R that pass the filter
+	for (uint32_t i = 0; i < c; i++)
+	{
+		toPass[i].rel = &R;
+		pthread_create( &threads[i], placement.attr(i), semi_join_count_size, &toPass[i]);
+	}
+	total_size = 0;
+	previous_total = 0;
+	for (uint32_t i = 0; i < c; i++)
+	{
+		pthread_join( threads[i], NULL);
+		total_size += sizes[i];
+		sizes[i] = previous_total;
+		previous_total = total_size;
+	}
+
+	// copy them to a new list, if any tuple is dropped
+	if (total_size != R.numRecords)
+	{
+		ExtendedRecord* reduced = (ExtendedRecord*) large_malloc( total_size*sizeof(ExtendedRecord) );
+		for (uint32_t i = 0; i < c; i++)
+		{
+			toPass[i].reduced = reduced;
+			pthread_create( &threads[i], placement.attr(i), semi_join_set, &toPass[i]);
+		}
+		for (uint32_t i = 0; i < c; i++)
+		{
+			pthread_join( threads[i], NULL);
+		}
+
+		large_free( R.record_list );
+		R.record_list = reduced;
+		R.numRecords = total_size;
+	}
+
+	free(sizes);
+}
+
+/*
+Semi-join reduction before sorting -
+filterR drops tuples of R whose non-temporal values don't exist in S, filterS does the same for S.
+A relation can be reduced only if its groups without a counterpart don't contribute to the result
+*/
+void mainSemiJoin( ExtendedRelation& R, ExtendedRelation& S, bool filterR, bool filterS, ThreadPlacement& placement, uint32_t c)
+{
+	#ifdef TIMES
+	Timer tim;
+	tim.start();
+	#endif
+
+	if (filterR)
+		reduce_relation( R, S, placement, c);
+	if (filterS)
+		reduce_relation( S, R, placement, c);
+
+	#ifdef TIMES
+	double timeSemiJoin = tim.stop();
+	std::cout << "SemiJoin time: " << timeSemiJoin << " and sizes " << R.numRecords << " " << S.numRecords << std::endl;
+	report_large_allocations("semi-join");
+	#endif
+}
@@ -0,0 +1,138 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+
+#include "../containers/relation.hpp"
+
+////////////////////
+// Internal loops //
+////////////////////
+
+template <typename T>
+bool startBefore(const TemporalRecord<T>& r, T t)
+{
+	return r.start < t;
+}
+
+template <typename T>
+bool startAfter(T t, const TemporalRecord<T>& r)
+{
+	return t < r.start;
+}
+
+/* copies the tuples of R that are long (or not) to P, keeping them sorted by start */
+template <typename T>
+void copy_by_length(const TemporalRelation<T>& R, T threshold, bool isLong, size_t numRecords, TemporalRelation<T>& P)
+{
+	P.record_list = (TemporalRecord<T>*) large_malloc( std::max(numRecords, (size_t) 1) * sizeof(TemporalRecord<T>) );
+	P.numRecords = numRecords;
+
+	TemporalRecord<T>* p = P.record_list;
+	const TemporalRecord<T>* lastR = R.record_list + R.numRecords;
+	for (const TemporalRecord<T>* r = R.record_list; r != lastR; r++)
+	{
+		// tuples that end before they start count as long, so short tuples never have a negative length
+		if ( ((T) (r->end - r->start) > threshold) != isLong )
+			continue;
+		*(p++) = *r;
+
+		P.minStart = std::min(P.minStart, r->start);
+		P.maxStart = std::max(P.maxStart, r->start);
+		P.minEnd   = std::min(P.minEnd  , r->end);
+		P.maxEnd   = std::max(P.maxEnd  , r->end);
+	}
+}
+
+//////////////////////////////
+// Single-thread processing //
+//////////////////////////////
+
+/*
+Splits R, sorted by start, in its tuples not longer than threshold (Short) and the rest (Long), both sorted by start.
+Returns false, without filling Short and Long, if R has no long tuple
+*/
+template <typename T>
+bool split_by_length(const TemporalRelation<T>& R, T threshold, TemporalRelation<T>& Short, TemporalRelation<T>& Long)
+{
+	size_t numLong = 0;
+	const TemporalRecord<T>* lastR = R.record_list + R.numRecords;
+	for (const TemporalRecord<T>* r = R.record_list; r != lastR; r++)
+		numLong += ( (T) (r->end - r->start) > threshold );
+	if (numLong == 0)
+		return false;
+
+	copy_by_length(R, threshold, false, R.numRecords - numLong, Short);
+	copy_by_length(R, threshold, true, numLong, Long);
+
+	return true;
+}
+
+/*
+Joins the tuples of Long with Short, whose tuples are sorted by start and not longer than threshold.
+A tuple of Short that overlaps a tuple of Long starts in [start - threshold, end) of it: the ones starting after start
+overlap for sure, the rest are compared. Both ranges are found with binary searches
+*/
+template <typename T>
+uint64_t long_short_join(const TemporalRelation<T>& Long, const TemporalRelation<T>& Short, T threshold)
+{
+	uint64_t result = 0;
+	const TemporalRecord<T>* firstS = Short.record_list;
+	const TemporalRecord<T>* lastS = Short.record_list + Short.numRecords;
+	const TemporalRecord<T>* lastL = Long.record_list + Long.numRecords;
+	for (const TemporalRecord<T>* r = Long.record_list; r != lastL; r++)
+	{
+		T from = (r->start > threshold) ? r->start - threshold : 0;
+		const TemporalRecord<T>* first = std::lower_bound( firstS, lastS, from, startBefore<T>);
+		const TemporalRecord<T>* inside = std::upper_bound( first, lastS, r->start, startAfter<T>);
+		const TemporalRecord<T>* last = std::lower_bound( inside, lastS, r->end, startBefore<T>);
+
+		for (const TemporalRecord<T>* s = first; s != inside; s++)
+		{
+			uint64_t overlap = (r->start < s->end) & (s->start < r->end);
+#ifdef WORKLOAD_COUNT
+			result += overlap;
+#else
+			result += (uint64_t) (r->start ^ s->start) & (0 - overlap);
+#endif
+		}
+#ifdef WORKLOAD_COUNT
+		result += last - inside;
+#else
+		for (const TemporalRecord<T>* s = inside; s != last; s++)
+			result += r->start ^ s->start;
+#endif
+	}
+
+	return result;
+}
+
+template bool split_by_length<Timestamp>(const Relation& R, Timestamp threshold, Relation& Short, Relation& Long);
+template bool split_by_length<ShortTimestamp>(const ShortRelation& R, ShortTimestamp threshold, ShortRelation& Short, ShortRelation& Long);
+template uint64_t long_short_join<Timestamp>(const Relation& Long, const Relation& Short, Timestamp threshold);
+template uint64_t long_short_join<ShortTimestamp>(const ShortRelation& Long, const ShortRelation& Short, ShortTimestamp threshold);
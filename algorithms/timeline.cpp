@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "../containers/relation.hpp"
+#include "../containers/timeline_index.hpp"
+
+////////////////////
+// Internal loops //
+////////////////////
+
+/* a tuple that starts overlaps with all active tuples of the other group */
+template <typename T>
+inline uint64_t timeline_report(T start, const TimelineActiveSet<T> &active)
+{
+#ifdef WORKLOAD_COUNT
+	return active.size;
+#else
+	uint64_t result = 0;
+	for (size_t i = 0; i < active.size; i++)
+		result += start ^ active.starts[i];
+	return result;
+#endif
+}
+
+
+//////////////////////////////
+// Single-thread processing //
+//////////////////////////////
+
+/*
+Joins R and S with a merge of their timelines, keeping the active tuples of each group.
+Each pair is reported once, when the tuple that starts last starts - ends come first at the same time, so tuples that only meet don't overlap.
+A zero-length tuple reports the tuples active at its point and never becomes active: tuples that end or start at the point come before or after it.
+Both timelines start at the first start point of the group that starts last, nothing before it can be a result
+*/
+template <typename T>
+uint64_t timeline_join(TemporalRelation<T> &R, TemporalTimelineIndex<T> &TR, TemporalRelation<T> &S, TemporalTimelineIndex<T> &TS)
+{
+	uint64_t result = 0;
+	TimelineActiveSet<T> activeR, activeS;
+	activeR.init( R.numRecords);
+	activeS.init( S.numRecords);
+
+	T from = std::max( R.minStart, S.minStart);
+	size_t er = TR.seek( R, from, activeR);
+	size_t es = TS.seek( S, from, activeS);
+
+	// once a timeline ends, no tuple of it is active any more
+	while ( (er < TR.numEvents) && (es < TS.numEvents) )
+	{
+		const TimelineEvent<T>& r = TR.event_list[er];
+		const TimelineEvent<T>& s = TS.event_list[es];
+		if ( !(s < r) )
+		{
+			Position tuple = r.code >> 2;
+			if ( (r.code & 3) == TIMELINE_END )
+				activeR.erase( tuple);
+			else
+			{
+				result += timeline_report( r.time, activeS);
+				if ( (r.code & 3) == TIMELINE_START )
+					activeR.insert( tuple, r.time);
+			}
+			er++;
+		}
+		else
+		{
+			Position tuple = s.code >> 2;
+			if ( (s.code & 3) == TIMELINE_END )
+				activeS.erase( tuple);
+			else
+			{
+				result += timeline_report( s.time, activeR);
+				if ( (s.code & 3) == TIMELINE_START )
+					activeS.insert( tuple, s.time);
+			}
+			es++;
+		}
+	}
+
+	return result;
+}
+
+template uint64_t timeline_join<Timestamp>(Relation &R, TimelineIndex &TR, Relation &S, TimelineIndex &TS);
+template uint64_t timeline_join<ShortTimestamp>(ShortRelation &R, TemporalTimelineIndex<ShortTimestamp> &TR, ShortRelation &S, TemporalTimelineIndex<ShortTimestamp> &TS);
@@ -32,10 +32,9 @@ BordersElement::BordersElement()
 {
 }
 
-BordersElement::BordersElement(uint32_t group1, uint32_t group2, uint32_t position_start, uint32_t position_end)
+BordersElement::BordersElement(GroupKey key, Position position_start, Position position_end)
 {
-	this->group1 = group1;
-	this->group2 = group2;
+	this->key = key;
 	this->position_start = position_start;
 	this->position_end = position_end;
 }
@@ -55,4 +54,33 @@ Borders::Borders()
 Borders::~Borders()
 {
 	free( this->borders_list );
+}
+
+/**************************************************************************************************/
+
+GroupPair::GroupPair()
+{
+}
+
+GroupPair::GroupPair(uint32_t r, uint32_t s)
+{
+	this->r = r;
+	this->s = s;
+}
+
+GroupPair::~GroupPair()
+{
+}
+
+/**************************************************************************************************/
+
+GroupPairs::GroupPairs()
+{
+	this->pairs_list = NULL;
+	this->numPairs = 0;
+}
+
+GroupPairs::~GroupPairs()
+{
+	free( this->pairs_list );
 }
\ No newline at end of file
@@ -26,18 +26,25 @@
  * DEALINGS IN THE SOFTWARE.
  ******************************************************************************/
 
+#ifndef _BORDERS_H_
+#define _BORDERS_H_
+
 #include "../def.hpp"
 
 class BordersElement
 {
 public:
-	uint32_t group1;
-	uint32_t group2;
-	uint32_t position_start;
-	uint32_t position_end;
+	GroupKey key;
+	Position position_start;
+	Position position_end;
+
+	// zone map of the group, used to prune and trim group pairs that can't overlap
+	Timestamp minStart, maxStart, minEnd, maxEnd;
+	// sum of the lengths of the tuples of the group, used to estimate the cost of joining it
+	Timestamp sumLength;
 
 	BordersElement();
-	BordersElement(uint32_t group1, uint32_t group2, uint32_t position_start, uint32_t position_end);
+	BordersElement(GroupKey key, Position position_start, Position position_end);
 	~BordersElement();
 };
 
@@ -51,4 +58,43 @@ public:
 
 	Borders();
 	~Borders();
-};
\ No newline at end of file
+};
+
+/**************************************************************************************************/
+
+#define NO_MATCH std::numeric_limits<uint32_t>::max()
+
+class GroupPair
+{
+public:
+	uint32_t r;			// position of the group in bordersR
+	uint32_t s;			// position of the group in bordersS
+
+	GroupPair();
+	GroupPair(uint32_t r, uint32_t s);
+	~GroupPair();
+};
+
+class GroupPairs
+{
+public:
+	GroupPair* pairs_list;
+	uint32_t numPairs;
+
+	GroupPairs();
+	~GroupPairs();
+};
+
+/* true if no interval of group a can overlap with an interval of group b */
+inline bool groupsDisjoint(const BordersElement& a, const BordersElement& b)
+{
+	return (a.minStart >= b.maxEnd) || (b.minStart >= a.maxEnd);
+}
+
+/* ordering of groups in sorted relations, which is also the ordering of Borders */
+inline bool groupLess(const BordersElement& a, const BordersElement& b)
+{
+	return a.key < b.key;
+}
+
+#endif //_BORDERS_H_
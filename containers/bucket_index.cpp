@@ -31,44 +31,51 @@
 
 
 
-Bucket::Bucket()
+template <typename T>
+TemporalBucket<T>::TemporalBucket()
 {
 }
 
 
-Bucket::Bucket(Record* i)
+template <typename T>
+TemporalBucket<T>::TemporalBucket(TemporalRecord<T>* i)
 {
 	this->last = i;
 }
 
 
-Bucket::~Bucket()
+template <typename T>
+TemporalBucket<T>::~TemporalBucket()
 {
 }
 
 
 
-BucketIndex::BucketIndex()
+template <typename T>
+TemporalBucketIndex<T>::TemporalBucketIndex()
 {
 	this->bucket_list = NULL;
 }
 
 
-void BucketIndex::build(const Relation &R, long int numBuckets)
+template <typename T>
+void TemporalBucketIndex<T>::build(const TemporalRelation<T> &R, long int numBuckets)
 {
 	long int cbucket_id = 0, btmp;
-	Record* i = R.record_list;
-	Record* lastI = R.record_list + R.numRecords;
+	TemporalRecord<T>* i = R.record_list;
+	TemporalRecord<T>* lastI = R.record_list + R.numRecords;
 	auto ms = R.maxStart;
 	
 	if (R.minStart == R.maxStart)
 		ms += 1;
 	
 	this->numBuckets = numBuckets;
-	this->bucket_range = (Timestamp)ceil((double)(ms-R.minStart)/this->numBuckets);
-	this->bucket_list = (Bucket*) malloc( numBuckets * sizeof(Bucket) );
+	this->minStart = R.minStart;
+	this->record_list = R.record_list;
+	this->bucket_range = (T)ceil((double)(ms-R.minStart)/this->numBuckets);
+	this->bucket_list = (TemporalBucket<T>*) malloc( numBuckets * sizeof(TemporalBucket<T>) );
 	for (long int i = 0; i < this->numBuckets; i++)
-		this->bucket_list[i] = Bucket(lastI);
+		this->bucket_list[i] = TemporalBucket<T>(lastI);
 
 	while (i != lastI)
 	{
@@ -94,7 +101,13 @@ void BucketIndex::build(const Relation &R, long int numBuckets)
 	}
 }
 
-BucketIndex::~BucketIndex()
+template <typename T>
+TemporalBucketIndex<T>::~TemporalBucketIndex()
 {
 	free( this->bucket_list );
 }
+
+template class TemporalBucket<Timestamp>;
+template class TemporalBucket<ShortTimestamp>;
+template class TemporalBucketIndex<Timestamp>;
+template class TemporalBucketIndex<ShortTimestamp>;
@@ -33,26 +33,42 @@
 #include "../def.hpp"
 #include "relation.hpp"
 
-class Bucket
+template <typename T>
+class TemporalBucket
 {
 public:
-	Record* last;
+	TemporalRecord<T>* last;
 
-	Bucket();
-	Bucket(Record* i);
-	~Bucket();
+	TemporalBucket();
+	TemporalBucket(TemporalRecord<T>* i);
+	~TemporalBucket();
 };
 
-class BucketIndex
+template <typename T>
+class TemporalBucketIndex
 {
 public:
-	Bucket* bucket_list;
+	TemporalBucket<T>* bucket_list;
 	long int numBuckets;
-	Timestamp bucket_range;
+	T bucket_range;
+	T minStart;
+	TemporalRecord<T>* record_list;
 	
-	BucketIndex();
-	void build(const Relation &R, long int numBuckets);
-	~BucketIndex();
+	TemporalBucketIndex();
+	void build(const TemporalRelation<T> &R, long int numBuckets);
+	/* tuples before lower start before t, tuples from upper on start after it - the ones in the bucket of t are in between */
+	inline void bounds(T t, TemporalRecord<T>*& lower, TemporalRecord<T>*& upper) const
+	{
+		long int bucket_id = ceil((double)(t-this->minStart)/this->bucket_range);
+		if (bucket_id >= this->numBuckets)
+			bucket_id = this->numBuckets-1;
+		lower = (bucket_id > 0) ? this->bucket_list[bucket_id-1].last : this->record_list;
+		upper = this->bucket_list[bucket_id].last;
+	}
+	~TemporalBucketIndex();
 };
 
+typedef TemporalBucket<Timestamp> Bucket;
+typedef TemporalBucketIndex<Timestamp> BucketIndex;
+
 #endif //_BUCKET_INDEX_H_
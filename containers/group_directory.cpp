@@ -0,0 +1,62 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "group_directory.hpp"
+
+GroupDirectory::GroupDirectory()
+{
+	this->keys = NULL;
+	this->groupR = NULL;
+	this->groupS = NULL;
+	this->numGroups = 0;
+
+	this->denseR = NULL;
+	this->denseS = NULL;
+	this->numBordersR = 0;
+	this->numBordersS = 0;
+}
+
+/* returns the dense id of the group with the given key, NO_MATCH if it doesn't exist in both relations */
+uint32_t GroupDirectory::find(GroupKey key) const
+{
+	GroupKey* pos = std::lower_bound( this->keys, this->keys + this->numGroups, key);
+
+	if ( (pos == this->keys + this->numGroups) || (*pos != key) )
+		return NO_MATCH;
+	return pos - this->keys;
+}
+
+GroupDirectory::~GroupDirectory()
+{
+	free( this->keys );
+	free( this->groupR );
+	free( this->groupS );
+	free( this->denseR );
+	free( this->denseS );
+}
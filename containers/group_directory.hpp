@@ -0,0 +1,60 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _GROUP_DIRECTORY_H_
+#define _GROUP_DIRECTORY_H_
+
+#include "../def.hpp"
+#include "borders.hpp"
+
+/*
+Directory of the groups that exist in both R and S, with dense ids [0,numGroups) in the order of their keys.
+Each dense id points to the position of the group in bordersR and bordersS. The complement of a relation keeps
+the positions of its Borders, so the same directory is used for complements.
+denseR/denseS give the dense id of each group of bordersR/bordersS, NO_MATCH if it exists only in one relation
+*/
+class GroupDirectory
+{
+public:
+	GroupKey* keys;
+	uint32_t* groupR;
+	uint32_t* groupS;
+	uint32_t numGroups;
+
+	uint32_t* denseR;
+	uint32_t* denseS;
+	uint32_t numBordersR;
+	uint32_t numBordersS;
+
+	GroupDirectory();
+	uint32_t find(GroupKey key) const;
+	~GroupDirectory();
+};
+
+#endif //_GROUP_DIRECTORY_H_
@@ -0,0 +1,149 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "hint_index.hpp"
+
+/*
+Partitions that cover cells [a,b] of a domain of 2^numBits cells, from the bottom level up - at most two per level.
+Returns their number, levels and partitions are filled in that order
+*/
+uint32_t hint_partitions(uint64_t a, uint64_t b, uint32_t numBits, uint32_t* levels, uint64_t* partitions)
+{
+	uint32_t n = 0;
+	for (uint32_t l = numBits; a <= b; l--)
+	{
+		if (a & 1)
+		{
+			levels[n] = l;
+			partitions[n++] = a;
+			a++;
+		}
+		if ( (a <= b) && !(b & 1) )
+		{
+			levels[n] = l;
+			partitions[n++] = b;
+			if (b == 0)
+				break;
+			b--;
+		}
+		a >>= 1;
+		b >>= 1;
+	}
+
+	return n;
+}
+
+template <typename T>
+TemporalHintIndex<T>::TemporalHintIndex()
+{
+	this->record_list = NULL;
+	this->offsets = NULL;
+	this->numRecords = 0;
+}
+
+/*
+Builds the index over R, which must be sorted by start point - tuples are placed in the order of R, so every subdivision stays sorted.
+A tuple covers [start,end-1], a zero-length tuple only the cell of its start, where it overlaps with tuples that contain it.
+R covers [minStart,maxEnd-1] of the domain, with maxEnd possibly a bound from the zone map of its group.
+Levels grow with the size of R, up to maxBits
+*/
+template <typename T>
+void TemporalHintIndex<T>::build(const TemporalRelation<T> &R, uint32_t maxBits)
+{
+	this->numRecords = R.numRecords;
+	if (R.numRecords == 0)
+		return;
+
+	this->base = R.minStart;
+	this->last = std::max( (T) (R.maxEnd - 1), R.record_list[R.numRecords-1].start);
+	this->numBits = 0;
+	while ( (this->numBits < maxBits) && ( ((size_t) 1 << this->numBits) < R.numRecords ) )
+		this->numBits++;
+	uint64_t span = (uint64_t) (this->last - this->base);
+	this->shift = 0;
+	while ( (span >> this->shift) >> this->numBits )
+		this->shift++;
+
+	// count tuples of each subdivision, then turn counts to offsets
+	size_t numSubdivisions = this->offset(this->numBits + 1, false, 0, 0);
+	this->offsets = (size_t*) calloc( numSubdivisions + 1, sizeof(size_t) );
+	uint32_t levels[128];
+	uint64_t partitions[128];
+	for (uint32_t pass = 0; pass < 2; pass++)
+	{
+		for (size_t i = 0; i < R.numRecords; i++)
+		{
+			const TemporalRecord<T>& r = R.record_list[i];
+			T lastCovered = (r.end > r.start) ? (T) (r.end - 1) : r.start;
+			uint64_t a = ((uint64_t) (r.start - this->base)) >> this->shift;
+			uint64_t b = ((uint64_t) (std::min(lastCovered, this->last) - this->base)) >> this->shift;
+			uint32_t n = hint_partitions(a, b, this->numBits, levels, partitions);
+
+			// original is the partition with the first cell, the one with the last cell holds the end
+			uint32_t original = 0;
+			for (uint32_t j = 1; j < n; j++)
+				if ( (partitions[j] << (this->numBits - levels[j])) < (partitions[original] << (this->numBits - levels[original])) )
+					original = j;
+
+			for (uint32_t j = 0; j < n; j++)
+			{
+				uint64_t lastCell = ((partitions[j] + 1) << (this->numBits - levels[j])) - 1;
+				size_t sub = this->offset( levels[j], (j != original), partitions[j], (lastCell >= b) ? HINT_IN : HINT_AFTER);
+				if (pass == 0)
+					this->offsets[sub+1]++;
+				else
+					this->record_list[ this->offsets[sub]++ ] = r;
+			}
+		}
+
+		if (pass == 0)
+		{
+			for (size_t s = 0; s < numSubdivisions; s++)
+				this->offsets[s+1] += this->offsets[s];
+			this->record_list = (TemporalRecord<T>*) malloc( this->offsets[numSubdivisions] * sizeof(TemporalRecord<T>) );
+		}
+		else
+		{
+			// second pass moved each offset to the start of the next subdivision
+			for (size_t s = numSubdivisions; s > 0; s--)
+				this->offsets[s] = this->offsets[s-1];
+			this->offsets[0] = 0;
+		}
+	}
+}
+
+template <typename T>
+TemporalHintIndex<T>::~TemporalHintIndex()
+{
+	free( this->record_list );
+	free( this->offsets );
+}
+
+template class TemporalHintIndex<Timestamp>;
+template class TemporalHintIndex<ShortTimestamp>;
@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _HINT_INDEX_H_
+#define _HINT_INDEX_H_
+
+#include "../def.hpp"
+#include "relation.hpp"
+
+/* subdivisions of a partition of HINT */
+#define HINT_IN 0		// tuples that end inside the partition
+#define HINT_AFTER 1	// tuples that end after the partition
+
+/*
+HINT: hierarchical index of a group, built over a binary decomposition of its time domain.
+The domain is split in 2^numBits cells of 2^shift timestamps, level l has 2^l partitions and level numBits has one per cell.
+Each tuple is assigned to the fewest partitions that cover its cells (at most two per level) - as original in the first of them,
+where it starts, else as replica - and each partition keeps originals and replicas apart, split by HINT_IN and HINT_AFTER.
+A probe only compares against the first and last partition it covers at each level, partitions in between are reported as they are.
+Tuples of each subdivision are kept sorted by start point
+*/
+template <typename T>
+class TemporalHintIndex
+{
+public:
+	TemporalRecord<T>* record_list;
+	size_t* offsets;			// first tuple of each subdivision, see offset()
+	size_t numRecords;
+	uint32_t numBits;
+	uint32_t shift;
+	T base;						// first timestamp of the domain
+	T last;						// last timestamp of the domain
+
+	TemporalHintIndex();
+	void build(const TemporalRelation<T> &R, uint32_t maxBits);
+	~TemporalHintIndex();
+
+	// position of subdivision sub of partition p of level l, originals of a level before its replicas
+	inline size_t offset(uint32_t l, bool replica, uint64_t p, uint32_t sub) const
+	{
+		return 4*( ((uint64_t) 1 << l) - 1 ) + (replica ? 2*((uint64_t) 1 << l) : 0) + 2*p + sub;
+	}
+};
+
+typedef TemporalHintIndex<Timestamp> HintIndex;
+
+#endif //_HINT_INDEX_H_
@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "key_filter.hpp"
+#include "large_alloc.hpp"
+
+/* bits of the filter per key and number of bits set for each key */
+#define KEY_FILTER_BITS_PER_KEY 8
+#define KEY_FILTER_PROBES 3
+
+/* mixes the packed non-temporal values in one 64-bit hash */
+inline uint64_t hash_key(GroupKey key)
+{
+	uint64_t h = key;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+KeyFilter::KeyFilter()
+{
+	this->bits = NULL;
+	this->mask = 0;
+}
+
+void KeyFilter::init(size_t numKeys)
+{
+	uint64_t numBits = 64;
+	while (numBits < (uint64_t) numKeys * KEY_FILTER_BITS_PER_KEY)
+		numBits *= 2;
+
+	this->mask = numBits - 1;
+	this->bits = (uint64_t*) large_calloc( numBits/64, sizeof(uint64_t) );
+}
+
+void KeyFilter::insert(GroupKey key)
+{
+	uint64_t h = hash_key(key);
+	uint64_t step = (h >> 32) | 1;
+
+	for (uint32_t i = 0; i < KEY_FILTER_PROBES; i++)
+	{
+		uint64_t bit = h & this->mask;
+		uint64_t word = ((uint64_t) 1) << (bit & 63);
+		if ( !(this->bits[bit >> 6] & word) )
+			__atomic_fetch_or( &this->bits[bit >> 6], word, __ATOMIC_RELAXED);
+		h += step;
+	}
+}
+
+bool KeyFilter::contains(GroupKey key) const
+{
+	uint64_t h = hash_key(key);
+	uint64_t step = (h >> 32) | 1;
+
+	for (uint32_t i = 0; i < KEY_FILTER_PROBES; i++)
+	{
+		uint64_t bit = h & this->mask;
+		if ( !(this->bits[bit >> 6] & (((uint64_t) 1) << (bit & 63))) )
+			return false;
+		h += step;
+	}
+
+	return true;
+}
+
+KeyFilter::~KeyFilter()
+{
+	large_free( this->bits );
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "large_alloc.hpp"
+#include <atomic>
+#include <sys/mman.h>
+
+/* kinds of memory given by large_malloc */
+#define LARGE_ALLOC_MALLOC 0
+#define LARGE_ALLOC_HUGETLB 1
+#define LARGE_ALLOC_TRANSPARENT 2
+
+/* header in front of each array, so that large_free knows how it was taken - a cache line, to keep arrays aligned */
+#define LARGE_ALLOC_HEADER 64
+
+struct LargeAllocation
+{
+	size_t size;		// bytes taken, including the header
+	int kind;		// LARGE_ALLOC_MALLOC, LARGE_ALLOC_HUGETLB or LARGE_ALLOC_TRANSPARENT
+};
+
+/* bytes currently taken for each kind */
+static std::atomic<size_t> large_alloc_bytes[3];
+
+static void* large_alloc_mmap(size_t size, int& kind)
+{
+#if defined(HUGE_PAGES) && defined(MAP_ANONYMOUS)
+	void* ptr;
+#ifdef MAP_HUGETLB
+	ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if (ptr != MAP_FAILED)
+	{
+		kind = LARGE_ALLOC_HUGETLB;
+		return ptr;
+	}
+#endif
+	ptr = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptr != MAP_FAILED)
+	{
+#ifdef MADV_HUGEPAGE
+		madvise( ptr, size, MADV_HUGEPAGE);
+#endif
+		kind = LARGE_ALLOC_TRANSPARENT;
+		return ptr;
+	}
+#endif
+	return NULL;
+}
+
+void* large_malloc(size_t size)
+{
+	int kind = LARGE_ALLOC_MALLOC;
+
+	// huge pages are taken in whole pages of HUGE_PAGE_SIZE, only for arrays of at least one page
+	size_t total = size + LARGE_ALLOC_HEADER;
+	size_t rounded = ( (total + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE ) * HUGE_PAGE_SIZE;
+	char* ptr = (size >= HUGE_PAGE_SIZE) ? (char*) large_alloc_mmap(rounded, kind) : NULL;
+	if (ptr != NULL)
+	{
+		total = rounded;
+	}
+	else
+	{
+		ptr = (char*) malloc(total);
+		if (ptr == NULL)
+			return NULL;
+	}
+
+	LargeAllocation* header = (LargeAllocation*) ptr;
+	header->size = total;
+	header->kind = kind;
+	large_alloc_bytes[kind] += total;
+
+	return ptr + LARGE_ALLOC_HEADER;
+}
+
+void* large_calloc(size_t count, size_t size)
+{
+	void* ptr = large_malloc(count*size);
+
+	// mmap gives zeroed pages, so only malloc memory needs to be cleared
+	if ( (ptr != NULL) && (((LargeAllocation*) ((char*) ptr - LARGE_ALLOC_HEADER))->kind == LARGE_ALLOC_MALLOC) )
+		memset( ptr, 0, count*size);
+
+	return ptr;
+}
+
+void large_free(void* ptr)
+{
+	if (ptr == NULL)
+		return;
+
+	LargeAllocation* header = (LargeAllocation*) ((char*) ptr - LARGE_ALLOC_HEADER);
+	large_alloc_bytes[header->kind] -= header->size;
+	if (header->kind == LARGE_ALLOC_MALLOC)
+		free(header);
+	else
+		munmap(header, header->size);
+}
+
+/* transparent huge pages that back the process, as reported by the kernel (0 if not available) */
+static size_t anon_huge_pages()
+{
+	std::ifstream smaps("/proc/self/smaps_rollup");
+	std::string field;
+	size_t kb;
+	while (smaps >> field)
+	{
+		if (field == "AnonHugePages:")
+		{
+			smaps >> kb;
+			return kb*1024;
+		}
+	}
+	return 0;
+}
+
+void report_large_allocations(const char* phase)
+{
+	std::cout << "Huge pages after " << phase << ": "
+				<< (large_alloc_bytes[LARGE_ALLOC_HUGETLB] >> 20) << " MB explicit, "
+				<< (large_alloc_bytes[LARGE_ALLOC_TRANSPARENT] >> 20) << " MB advised (" << (anon_huge_pages() >> 20) << " MB backed), "
+				<< (large_alloc_bytes[LARGE_ALLOC_MALLOC] >> 20) << " MB on base pages" << std::endl;
+}
@@ -0,0 +1,48 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _LARGE_ALLOC_H_
+#define _LARGE_ALLOC_H_
+
+#include "../def.hpp"
+
+/*
+Allocation of the big arrays (tuples, complements, filters).
+If HUGE_PAGES is set, arrays of at least HUGE_PAGE_SIZE bytes are placed on explicit huge pages if the system has them reserved,
+else on memory advised for transparent huge pages, else on plain malloc. Smaller arrays always come from malloc.
+Memory taken with large_malloc must be released with large_free.
+*/
+void* large_malloc(size_t size);
+void* large_calloc(size_t count, size_t size);
+void large_free(void* ptr);
+
+/* prints how many bytes of the big arrays are on each kind of pages */
+void report_large_allocations(const char* phase);
+
+#endif //_LARGE_ALLOC_H_
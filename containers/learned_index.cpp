@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "learned_index.hpp"
+
+template <typename T>
+LearnedSegment<T>::LearnedSegment()
+{
+}
+
+template <typename T>
+LearnedSegment<T>::LearnedSegment(T start, double position, double slope)
+{
+	this->start = start;
+	this->position = position;
+	this->slope = slope;
+}
+
+template <typename T>
+LearnedSegment<T>::~LearnedSegment()
+{
+}
+
+template <typename T>
+TemporalLearnedIndex<T>::TemporalLearnedIndex()
+{
+	this->record_list = NULL;
+	this->numRecords = 0;
+}
+
+/*
+Builds the pieces with a shrinking cone: a piece starts at a start point and grows while some slope
+keeps all its start points within maxError of the position of their first tuple.
+The slope of a piece is the middle of the slopes that are left when the next start point doesn't fit
+*/
+template <typename T>
+void TemporalLearnedIndex<T>::build(const TemporalRelation<T> &R, size_t maxError)
+{
+	this->record_list = R.record_list;
+	this->numRecords = R.numRecords;
+	this->maxError = maxError;
+	this->segment_list.clear();
+
+	if (R.numRecords == 0)
+	{
+		this->segment_list.push_back( LearnedSegment<T>(0, 0, 0) );
+		return;
+	}
+
+	T first = R.record_list[0].start;
+	double firstPosition = 0;
+	double slopeLow = 0, slopeHigh = std::numeric_limits<double>::infinity();
+	for (size_t i = 1; i < R.numRecords; i++)
+	{
+		T start = R.record_list[i].start;
+		if (start == R.record_list[i-1].start)
+			continue;
+
+		double distance = (double) (start - first);
+		double low = ((double) i - maxError - firstPosition) / distance;
+		double high = ((double) i + maxError - firstPosition) / distance;
+		if ( (low > slopeHigh) || (high < slopeLow) )
+		{
+			double slope = (slopeHigh == std::numeric_limits<double>::infinity()) ? 0 : (slopeLow + slopeHigh) / 2;
+			this->segment_list.push_back( LearnedSegment<T>(first, firstPosition, slope) );
+
+			first = start;
+			firstPosition = i;
+			slopeLow = 0;
+			slopeHigh = std::numeric_limits<double>::infinity();
+			continue;
+		}
+		slopeLow = std::max(slopeLow, low);
+		slopeHigh = std::min(slopeHigh, high);
+	}
+	double slope = (slopeHigh == std::numeric_limits<double>::infinity()) ? 0 : (slopeLow + slopeHigh) / 2;
+	this->segment_list.push_back( LearnedSegment<T>(first, firstPosition, slope) );
+}
+
+template <typename T>
+TemporalLearnedIndex<T>::~TemporalLearnedIndex()
+{
+}
+
+template class LearnedSegment<Timestamp>;
+template class LearnedSegment<ShortTimestamp>;
+template class TemporalLearnedIndex<Timestamp>;
+template class TemporalLearnedIndex<ShortTimestamp>;
@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+
+#ifndef _LEARNED_INDEX_H_
+#define _LEARNED_INDEX_H_
+
+#include "../def.hpp"
+#include "relation.hpp"
+
+/* linear piece of a learned index - predicts position + slope*(t - start) for times from start to the next piece */
+template <typename T>
+class LearnedSegment
+{
+public:
+	T start;
+	double position;
+	double slope;
+
+	LearnedSegment();
+	LearnedSegment(T start, double position, double slope);
+	~LearnedSegment();
+};
+
+/*
+Learned index over the start points of a relation sorted by start: a piecewise linear model of the position of the first tuple
+that starts at each start point, within maxError of it, and a search around the prediction for the exact position.
+It replaces the buckets of TemporalBucketIndex where start points are far from uniform, with the same lookup:
+bounds() gives the first tuple that starts at or after t both as lower and upper bound, so forward scans compare no start point
+*/
+template <typename T>
+class TemporalLearnedIndex
+{
+public:
+	TemporalRecord<T>* record_list;
+	size_t numRecords;
+	std::vector< LearnedSegment<T> > segment_list;
+	size_t maxError;
+
+	TemporalLearnedIndex();
+	void build(const TemporalRelation<T> &R, size_t maxError);
+	inline TemporalRecord<T>* find(T t) const
+	{
+		// piece of t, with a binary search over the start points of the pieces
+		size_t from = 0, till = this->segment_list.size();
+		while (till - from > 1)
+		{
+			size_t mid = (from + till) / 2;
+			if (this->segment_list[mid].start <= t)
+				from = mid;
+			else
+				till = mid;
+		}
+		const LearnedSegment<T>& segment = this->segment_list[from];
+		double predicted = segment.position + segment.slope * ((t > segment.start) ? (double) (t - segment.start) : 0.0);
+		size_t p = (predicted <= 0) ? 0 : std::min( (size_t) predicted, this->numRecords);
+
+		// the error holds for the start points of the model, so the window is widened only for times between distant start points
+		size_t step = this->maxError + 1;
+		size_t lo = (p > step) ? p - step : 0;
+		size_t hi = std::min( p + step, this->numRecords);
+		while ( (lo > 0) && (this->record_list[lo-1].start >= t) )
+		{
+			hi = lo;
+			lo = (lo > step) ? lo - step : 0;
+			step *= 2;
+		}
+		while ( (hi < this->numRecords) && (this->record_list[hi].start < t) )
+		{
+			lo = hi + 1;
+			hi = std::min( hi + step, this->numRecords);
+			step *= 2;
+		}
+		while (lo < hi)
+		{
+			size_t mid = (lo + hi) / 2;
+			if (this->record_list[mid].start < t)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return this->record_list + lo;
+	}
+	inline void bounds(T t, TemporalRecord<T>*& lower, TemporalRecord<T>*& upper) const
+	{
+		lower = upper = find(t);
+	}
+	~TemporalLearnedIndex();
+};
+
+typedef TemporalLearnedIndex<Timestamp> LearnedIndex;
+
+#endif //_LEARNED_INDEX_H_
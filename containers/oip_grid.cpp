@@ -0,0 +1,90 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "oip_grid.hpp"
+
+template <typename T>
+TemporalOipGrid<T>::TemporalOipGrid()
+{
+	this->record_list = NULL;
+	this->offsets = NULL;
+}
+
+/*
+Builds the grid of R over the domain [base,last], shared with the group R is joined with.
+Tuples that don't end after their start go to partition (g,g) of the granule g of their start,
+the last granule if they start right after the domain
+*/
+template <typename T>
+void TemporalOipGrid<T>::build(const TemporalRelation<T> &R, T base, T last, uint32_t numGranules)
+{
+	this->numGranules = numGranules;
+	this->base = base;
+	this->granule = (T) ( ((uint64_t) (last - base)) / numGranules + 1 );
+
+	size_t numPartitions = (size_t) numGranules * numGranules;
+	this->offsets = (size_t*) calloc( numPartitions + 1, sizeof(size_t) );
+	uint32_t* partitionOf = (uint32_t*) malloc( R.numRecords * sizeof(uint32_t) );
+	for (size_t i = 0; i < R.numRecords; i++)
+	{
+		const TemporalRecord<T>& r = R.record_list[i];
+		uint32_t first = std::min( (uint32_t) ((r.start - base) / this->granule), numGranules - 1);
+		uint32_t lastGranule = (r.end > r.start) ? (r.end - 1 - base) / this->granule : first;
+		partitionOf[i] = first * numGranules + lastGranule;
+		this->offsets[ partitionOf[i] + 1 ]++;
+	}
+
+	for (uint32_t p = 0; p < numPartitions; p++)
+	{
+		if (this->offsets[p+1] != 0)
+			this->partitions.push_back(p);
+		this->offsets[p+1] += this->offsets[p];
+	}
+
+	this->record_list = (TemporalRecord<T>*) malloc( this->offsets[numPartitions] * sizeof(TemporalRecord<T>) );
+	for (size_t i = 0; i < R.numRecords; i++)
+		this->record_list[ this->offsets[ partitionOf[i] ]++ ] = R.record_list[i];
+
+	// filling moved each offset to the start of the next partition
+	for (size_t p = numPartitions; p > 0; p--)
+		this->offsets[p] = this->offsets[p-1];
+	this->offsets[0] = 0;
+
+	free( partitionOf );
+}
+
+template <typename T>
+TemporalOipGrid<T>::~TemporalOipGrid()
+{
+	free( this->record_list );
+	free( this->offsets );
+}
+
+template class TemporalOipGrid<Timestamp>;
+template class TemporalOipGrid<ShortTimestamp>;
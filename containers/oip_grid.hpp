@@ -0,0 +1,61 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _OIP_GRID_H_
+#define _OIP_GRID_H_
+
+#include "../def.hpp"
+#include "relation.hpp"
+
+/*
+Overlap interval partitioning of a group: the domain [base,base+numGranules*granule) is split in numGranules granules
+and partition (i,j), i <= j, keeps the tuples that start in granule i and end in granule j.
+Partitions (i,j) and (k,l) of two groups can overlap only if i <= l and k <= j,
+and all their pairs overlap if a granule is strictly inside both [i,j] and [k,l].
+Tuples of each partition are kept in the order of the group
+*/
+template <typename T>
+class TemporalOipGrid
+{
+public:
+	TemporalRecord<T>* record_list;
+	size_t* offsets;					// first tuple of partition (i,j) at i*numGranules+j
+	std::vector<uint32_t> partitions;	// partitions that have tuples, in increasing order
+	uint32_t numGranules;
+	T base;
+	T granule;
+
+	TemporalOipGrid();
+	void build(const TemporalRelation<T> &R, T base, T last, uint32_t numGranules);
+	~TemporalOipGrid();
+};
+
+typedef TemporalOipGrid<Timestamp> OipGrid;
+
+#endif //_OIP_GRID_H_
@@ -0,0 +1,325 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "placement.hpp"
+
+/* reads a list of ids like "0-3,8,10-11" */
+void parse_id_list(const std::string& list, std::vector<uint32_t>& ids)
+{
+	size_t pos = 0;
+	while (pos < list.size())
+	{
+		size_t comma = list.find(',', pos);
+		if (comma == std::string::npos)
+			comma = list.size();
+		std::string range = list.substr(pos, comma - pos);
+		size_t dash = range.find('-');
+		if (!range.empty())
+		{
+			uint32_t first = atoi( range.c_str() );
+			uint32_t last = (dash == std::string::npos) ? first : atoi( range.c_str() + dash + 1 );
+			for (uint32_t id = first; id <= last; id++)
+				ids.push_back(id);
+		}
+		pos = comma + 1;
+	}
+}
+
+/* reads the cpus of each memory node, keeping only cpus the process may run on - one node with all cpus if it's unknown */
+void read_node_cpus(std::vector< std::vector<uint32_t> >& nodeCpus)
+{
+#ifdef __linux__
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0)
+		return;
+
+	std::string list;
+	std::ifstream online("/sys/devices/system/node/online");
+	std::vector<uint32_t> nodes;
+	if (online >> list)
+		parse_id_list(list, nodes);
+
+	for (uint32_t n = 0; n < nodes.size(); n++)
+	{
+		std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(nodes[n]) + "/cpulist");
+		std::vector<uint32_t> cpus, usable;
+		if (cpulist >> list)
+			parse_id_list(list, cpus);
+		for (uint32_t i = 0; i < cpus.size(); i++)
+			if ( (cpus[i] < CPU_SETSIZE) && CPU_ISSET(cpus[i], &allowed) )
+				usable.push_back(cpus[i]);
+
+		// memory-only nodes can't run threads
+		if (!usable.empty())
+			nodeCpus.push_back(usable);
+	}
+
+	if (nodeCpus.empty())
+	{
+		std::vector<uint32_t> usable;
+		for (uint32_t cpu = 0; cpu < CPU_SETSIZE; cpu++)
+			if (CPU_ISSET(cpu, &allowed))
+				usable.push_back(cpu);
+		nodeCpus.push_back(usable);
+	}
+#endif
+}
+
+/* reads an id of the topology of a cpu, -1 if it's unknown */
+long read_cpu_topology(uint32_t cpu, const char* field)
+{
+	std::ifstream inp("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/" + field);
+	long id;
+	if (inp >> id)
+		return id;
+	return -1;
+}
+
+/* sets node, core and smt rank of the cpus of each node */
+void read_cpus(const std::vector< std::vector<uint32_t> >& nodeCpus, std::vector<PlacementCpu>& cpus)
+{
+	std::vector< std::pair<long,long> > cores;		// (package, core id) of each physical core
+	for (uint32_t n = 0; n < nodeCpus.size(); n++)
+	{
+		for (uint32_t i = 0; i < nodeCpus[n].size(); i++)
+		{
+			PlacementCpu c;
+			c.cpu = nodeCpus[n][i];
+			c.node = n;
+
+			// cpus without topology information are cores of their own
+			long package = read_cpu_topology(c.cpu, "physical_package_id");
+			long core = read_cpu_topology(c.cpu, "core_id");
+			std::pair<long,long> id = (core < 0) ? std::make_pair( (long) -1, (long) c.cpu) : std::make_pair(package, core);
+			c.core = std::find(cores.begin(), cores.end(), id) - cores.begin();
+			if (c.core == cores.size())
+				cores.push_back(id);
+
+			c.smt = 0;
+			for (uint32_t j = 0; j < cpus.size(); j++)
+				if (cpus[j].core == c.core)
+					c.smt++;
+			cpus.push_back(c);
+		}
+	}
+}
+
+bool compactOrder(const PlacementCpu& a, const PlacementCpu& b)
+{
+	if (a.node != b.node)
+		return a.node < b.node;
+	if (a.core != b.core)
+		return a.core < b.core;
+	return a.smt < b.smt;
+}
+
+/* cpus in the order a policy gives them to threads */
+void order_cpus(const std::vector<PlacementCpu>& cpus, uint32_t numNodes, int policy, std::vector<PlacementCpu>& order)
+{
+	if (policy == PLACEMENT_SCATTER)
+	{
+		// k-th core of each node in turn, first hardware threads before second ones
+		std::vector<PlacementCpu> sorted = cpus;
+		std::sort( sorted.begin(), sorted.end(), compactOrder);
+		uint32_t maxSmt = 0;
+		for (uint32_t i = 0; i < sorted.size(); i++)
+			maxSmt = std::max(maxSmt, sorted[i].smt);
+		for (uint32_t smt = 0; smt <= maxSmt; smt++)
+		{
+			std::vector< std::vector<PlacementCpu> > perNode(numNodes);
+			for (uint32_t i = 0; i < sorted.size(); i++)
+				if (sorted[i].smt == smt)
+					perNode[ sorted[i].node ].push_back( sorted[i] );
+			for (uint32_t k = 0; ; k++)
+			{
+				bool any = false;
+				for (uint32_t n = 0; n < numNodes; n++)
+				{
+					if (k < perNode[n].size())
+					{
+						order.push_back( perNode[n][k] );
+						any = true;
+					}
+				}
+				if (!any)
+					break;
+			}
+		}
+	}
+	else
+	{
+		for (uint32_t i = 0; i < cpus.size(); i++)
+			if ( (policy == PLACEMENT_COMPACT) || (cpus[i].smt == 0) )
+				order.push_back( cpus[i] );
+		std::sort( order.begin(), order.end(), compactOrder);
+	}
+}
+
+bool nodeOrder(const PlacementCpu& a, const PlacementCpu& b)
+{
+	return a.node < b.node;
+}
+
+ThreadPlacement::ThreadPlacement()
+{
+	this->numThreads = 0;
+	this->numNodes = 1;
+	this->nodeOfThread = NULL;
+	this->policy = PLACEMENT_NONE;
+	this->attrs = NULL;
+}
+
+void ThreadPlacement::init(uint32_t numThreads, int policy)
+{
+	this->numThreads = numThreads;
+	this->policy = policy;
+	read_node_cpus(this->nodeCpus);
+	read_cpus(this->nodeCpus, this->cpus);
+	this->numNodes = std::max( (uint32_t) this->nodeCpus.size(), (uint32_t) 1);
+
+	this->nodeOfThread = (uint32_t*) malloc( numThreads*sizeof(uint32_t) );
+	for (uint32_t t = 0; t < numThreads; t++)
+		this->nodeOfThread[t] = ((uint64_t) t * this->numNodes) / numThreads;
+
+#ifdef __linux__
+	if ( (policy != PLACEMENT_NONE) && !this->cpus.empty() )
+	{
+		// first numThreads cpus of the policy (reused if there are more threads), numbered by node
+		std::vector<PlacementCpu> order, chosen;
+		order_cpus(this->cpus, this->numNodes, policy, order);
+		for (uint32_t t = 0; t < numThreads; t++)
+			chosen.push_back( order[t % order.size()] );
+		std::stable_sort( chosen.begin(), chosen.end(), nodeOrder);
+
+		this->attrs = (pthread_attr_t*) malloc( numThreads*sizeof(pthread_attr_t) );
+		for (uint32_t t = 0; t < numThreads; t++)
+		{
+			this->nodeOfThread[t] = chosen[t].node;
+			this->cpuOfThread.push_back( chosen[t].cpu );
+
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			CPU_SET(chosen[t].cpu, &cpuset);
+			pthread_attr_init( &this->attrs[t] );
+			pthread_attr_setaffinity_np( &this->attrs[t], sizeof(cpu_set_t), &cpuset);
+		}
+	}
+#ifdef NUMA_AWARE
+	else if (this->numNodes > 1)
+	{
+		this->attrs = (pthread_attr_t*) malloc( numThreads*sizeof(pthread_attr_t) );
+		for (uint32_t t = 0; t < numThreads; t++)
+		{
+			cpu_set_t cpuset;
+			CPU_ZERO(&cpuset);
+			std::vector<uint32_t>& node = this->nodeCpus[ this->nodeOfThread[t] ];
+			for (uint32_t i = 0; i < node.size(); i++)
+				CPU_SET(node[i], &cpuset);
+
+			pthread_attr_init( &this->attrs[t] );
+			pthread_attr_setaffinity_np( &this->attrs[t], sizeof(cpu_set_t), &cpuset);
+		}
+	}
+#endif
+#endif
+}
+/* node of the thread that gets position p of [0,numRecords), if it's split between the threads with chunk_to_read */
+uint32_t ThreadPlacement::nodeOfPosition(Position p, Position numRecords) const
+{
+	if ( (this->numNodes == 1) || (numRecords == 0) )
+		return 0;
+
+	// first modResult chunks have divResult+1 positions, the rest divResult
+	Position divResult = numRecords / this->numThreads;
+	Position modResult = numRecords % this->numThreads;
+	Position chunk;
+	if (p < modResult*(divResult+1))
+		chunk = p / (divResult+1);
+	else
+		chunk = modResult + (p - modResult*(divResult+1)) / divResult;
+
+	return this->nodeOfThread[ std::min(chunk, (Position) this->numThreads-1) ];
+}
+
+/* attributes to create thread threadId with, NULL if it doesn't need to be pinned */
+pthread_attr_t* ThreadPlacement::attr(uint32_t threadId)
+{
+	return (this->attrs == NULL) ? NULL : &this->attrs[threadId];
+}
+
+/*
+Pins the calling (master) thread to the cpus of the node of thread 0, with or without a policy.
+The master thread sorts and schedules, so it takes the whole node rather than the cpus of the workers, where it would busy-wait next to them.
+Threads inherit the mask of the thread that creates them, so every thread is created with attr instead
+*/
+void ThreadPlacement::pinMaster()
+{
+#ifdef __linux__
+	if ( (this->attrs == NULL) || this->nodeCpus.empty() )
+		return;
+
+	cpu_set_t cpuset;
+	CPU_ZERO(&cpuset);
+	std::vector<uint32_t>& node = this->nodeCpus[ this->nodeOfThread[0] ];
+	for (uint32_t i = 0; i < node.size(); i++)
+		CPU_SET(node[i], &cpuset);
+	pthread_setaffinity_np( pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+}
+
+/* prints the topology found and the cpus chosen for the threads */
+void ThreadPlacement::report() const
+{
+	const char* names[] = { "none", "compact", "scatter", "physical" };
+	uint32_t numCores = 0;
+	for (uint32_t i = 0; i < this->cpus.size(); i++)
+		numCores = std::max(numCores, this->cpus[i].core + 1);
+
+	std::cout << "Placement: " << names[this->policy] << " on " << this->numNodes << " nodes, "
+				<< numCores << " cores, " << this->cpus.size() << " cpus";
+	if (!this->cpuOfThread.empty())
+	{
+		std::cout << " - threads on cpus";
+		for (uint32_t t = 0; t < this->numThreads; t++)
+			std::cout << " " << this->cpuOfThread[t];
+	}
+	std::cout << std::endl;
+}
+
+ThreadPlacement::~ThreadPlacement()
+{
+	if (this->attrs != NULL)
+	{
+		for (uint32_t t = 0; t < this->numThreads; t++)
+			pthread_attr_destroy( &this->attrs[t] );
+		free( this->attrs );
+	}
+	free( this->nodeOfThread );
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _PLACEMENT_H_
+#define _PLACEMENT_H_
+
+#include "../def.hpp"
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+/* cpu that can run a thread, with its place in the topology */
+struct PlacementCpu
+{
+	uint32_t cpu;
+	uint32_t node;			// index in nodeCpus
+	uint32_t core;			// physical core, unique over packages
+	uint32_t smt;			// rank of the cpu among the hardware threads of its core
+};
+
+/*
+Placement of the worker threads [0,numThreads) on the memory nodes and cpus of the machine.
+Without a policy, threads are spread in equal blocks over the nodes that have cpus, thread t on node t*numNodes/numThreads,
+and if NUMA_AWARE is set and there are more than one nodes, each thread is created pinned to the cpus of its node.
+With a policy, each thread is pinned to one cpu, chosen by:
+	compact  --> fill the hardware threads of a core, then the next core, then the next node
+	scatter  --> one hardware thread of each core, round robin over the nodes, before second hardware threads
+	physical --> only the first hardware thread of each core, filled as compact
+Threads are numbered in the order of the nodes of their cpus in any case.
+Parallel passes that split [0,numRecords) with chunk_to_read give chunk t to thread t, so the tuples written by thread t
+are first-touched on its node - nodeOfPosition gives that node for a position.
+*/
+class ThreadPlacement
+{
+public:
+	uint32_t numThreads;
+	uint32_t numNodes;			// memory nodes with cpus available to the process
+	uint32_t* nodeOfThread;
+	int policy;
+
+	std::vector< std::vector<uint32_t> > nodeCpus;
+	std::vector<PlacementCpu> cpus;		// cpus available to the process
+	std::vector<uint32_t> cpuOfThread;	// cpu each thread is pinned to, if a policy is set
+	pthread_attr_t* attrs;			// attributes to create each thread with, NULL if threads are not pinned
+
+	ThreadPlacement();
+	void init(uint32_t numThreads, int policy);
+	uint32_t nodeOfPosition(Position p, Position numRecords) const;
+	pthread_attr_t* attr(uint32_t threadId);
+	void pinMaster();
+	void report() const;
+	~ThreadPlacement();
+};
+
+#endif //_PLACEMENT_H_
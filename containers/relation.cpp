@@ -34,12 +34,11 @@ ExtendedRecord::ExtendedRecord()
 {
 }
 
-ExtendedRecord::ExtendedRecord(Timestamp start, Timestamp end, uint32_t group1, uint32_t group2)
+ExtendedRecord::ExtendedRecord(Timestamp start, Timestamp end, GroupKey key)
 {
 	this->start = start;
 	this->end = end;
-	this->group1 = group1;
-	this->group2 = group2;
+	this->key = key;
 }
 
 ExtendedRecord::~ExtendedRecord()
@@ -51,6 +50,15 @@ ExtendedRecord::~ExtendedRecord()
 ExtendedRelation::ExtendedRelation()
 {
 	this->record_list = NULL;
+	this->sorted_list = NULL;
+#ifdef SOA_RECORDS
+	this->sorted_start = NULL;
+	this->sorted_end = NULL;
+#endif
+	this->key_columns = NULL;
+	this->numKeys = 0;
+	for (uint32_t k = 0; k < MAX_KEY_COLUMNS; k++)
+		this->stringKeys[k] = false;
 
 	this->minStart = std::numeric_limits<Timestamp>::max();
 	this->maxEnd   = std::numeric_limits<Timestamp>::min();
@@ -58,31 +66,65 @@ ExtendedRelation::ExtendedRelation()
 	this->numRecords = 0;
 }
 
-void ExtendedRelation::load(const char *filename)
+/*
+reads a relation with numKeys non-temporal values after start and end in each line.
+Non-temporal values are kept in key_columns, until they are packed to a GroupKey for both relations.
+Values of string key columns are kept as ids of local_dictionary, until they are encoded for both relations
+*/
+void ExtendedRelation::load(const char *filename, uint32_t numKeys, const bool* stringKeys)
 {
 	Timestamp start, end;
-	uint32_t group1, group2;
+	uint32_t group;
+	std::string token;
 	std::ifstream inp(filename);
 	if (!inp)
 	{
 		std::cout << "error - cannot open file " << filename << std::endl;
 		exit(1);
 	}
+	this->numKeys = numKeys;
+	for (uint32_t k = 0; k < numKeys; k++)
+		this->stringKeys[k] = stringKeys[k];
 
-	while (inp >> start >> end >> group1 >> group2)
+	while (inp >> start >> end)
 	{
+		uint32_t k = 0;
+		while ( (k < numKeys) && (stringKeys[k] ? (bool) (inp >> token) : (bool) (inp >> group)) )
+			k++;
+		if (k != numKeys)
+			break;
 		this->numRecords++;
 	}
-	this->record_list = (ExtendedRecord*) malloc(sizeof(ExtendedRecord)*this->numRecords);
+#ifdef SHORT_POSITIONS
+	if (this->numRecords > std::numeric_limits<Position>::max())
+	{
+		std::cout << "error - " << filename << " has more tuples than SHORT_POSITIONS allows" << std::endl;
+		exit(1);
+	}
+#endif
+	this->record_list = (ExtendedRecord*) large_malloc(sizeof(ExtendedRecord)*this->numRecords);
+	this->key_columns = (uint32_t*) large_malloc(sizeof(uint32_t)*this->numRecords*numKeys);
 	inp.close();
 
 	inp.open(filename);
 	size_t i = 0;
 	while (i < this->numRecords)
 	{
-		inp >> start >> end >> group1 >> group2;
+		inp >> start >> end;
+		for (uint32_t k = 0; k < numKeys; k++)
+		{
+			if (stringKeys[k])
+			{
+				inp >> token;
+				this->key_columns[i*numKeys + k] = this->local_dictionary[k].emplace( token, this->local_dictionary[k].size()).first->second;
+			}
+			else
+			{
+				inp >> this->key_columns[i*numKeys + k];
+			}
+		}
 
-		this->record_list[i] = ExtendedRecord(start, end, group1, group2);
+		this->record_list[i] = ExtendedRecord(start, end, 0);
 
 		this->minStart = std::min(this->minStart, start);
 		this->maxEnd   = std::max(this->maxEnd  , end);
@@ -92,68 +134,125 @@ void ExtendedRelation::load(const char *filename)
 	inp.close();
 }
 
+/* allocates the tuples after sorting, which are then set with setSorted */
+void ExtendedRelation::allocateSorted(size_t numRecords)
+{
+#ifdef SOA_RECORDS
+	this->sorted_start = (Timestamp*) large_malloc( numRecords * sizeof(Timestamp) );
+	this->sorted_end = (Timestamp*) large_malloc( numRecords * sizeof(Timestamp) );
+#else
+	this->sorted_list = (SortedRecord*) large_malloc( numRecords * sizeof(SortedRecord) );
+#endif
+}
+
 ExtendedRelation::~ExtendedRelation()
 {
-	free( this->record_list );
+#ifdef SOA_RECORDS
+	large_free( this->sorted_start );
+	large_free( this->sorted_end );
+#endif
+	if ( (void*) this->sorted_list != (void*) this->record_list )
+		large_free( this->sorted_list );
+	large_free( this->record_list );
+	large_free( this->key_columns );
 }
 
 /**************************************************************************************************/
 
-Record::Record()
+template <typename T>
+TemporalRecord<T>::TemporalRecord()
 {
 }
 
-Record::Record(Timestamp start, Timestamp end)
+template <typename T>
+TemporalRecord<T>::TemporalRecord(T start, T end)
 {
 	this->start = start;
 	this->end = end;
 }
 
-bool Record::operator < (const Record& rhs) const
+template <typename T>
+bool TemporalRecord<T>::operator < (const TemporalRecord<T>& rhs) const
 {
 	return this->start < rhs.start;
 }
 
-bool Record::operator >= (const Record& rhs) const
+template <typename T>
+bool TemporalRecord<T>::operator >= (const TemporalRecord<T>& rhs) const
 {
 	return !((*this) < rhs);
 }
 
-Record::~Record()
+template <typename T>
+TemporalRecord<T>::~TemporalRecord()
 {
 }
 
+template class TemporalRecord<Timestamp>;
+template class TemporalRecord<ShortTimestamp>;
+
 /**************************************************************************************************/
 
-Relation::Relation()
+template <typename T>
+TemporalRelation<T>::TemporalRelation()
 {
-	this->minStart = std::numeric_limits<Timestamp>::max();
-	this->maxStart = std::numeric_limits<Timestamp>::min();
-	this->minEnd   = std::numeric_limits<Timestamp>::max();
-	this->maxEnd   = std::numeric_limits<Timestamp>::min();
+	this->minStart = std::numeric_limits<T>::max();
+	this->maxStart = std::numeric_limits<T>::min();
+	this->minEnd   = std::numeric_limits<T>::max();
+	this->maxEnd   = std::numeric_limits<T>::min();
 
 	this->record_list = NULL;
 	this->numRecords = 0;
 }
 
-void Relation::load(const ExtendedRelation& I, size_t from, size_t till)
+/*
+loads positions [from,till] of a relation sorted by start.
+Timestamps are truncated to T, so T must hold every timestamp of the join (see fitsShortTimestamps)
+*/
+template <typename T>
+void TemporalRelation<T>::load(const ExtendedRelation& I, size_t from, size_t till)
 {
-	this->record_list = (Record*) malloc( (till - from + 1) * sizeof(Record) );
+	this->record_list = (TemporalRecord<T>*) large_malloc( (till - from + 1) * sizeof(TemporalRecord<T>) );
 
 	for (size_t i = from; i <= till; i++)
 	{
-		this->record_list[i - from] = Record(I.record_list[i].start, I.record_list[i].end);
+		TemporalRecord<T> r((T) I.getStart(i), (T) I.getEnd(i));
+		this->record_list[i - from] = r;
 
-		this->minStart = std::min(this->minStart, I.record_list[i].start);
-		this->maxStart = std::max(this->maxStart, I.record_list[i].start);
-		this->minEnd   = std::min(this->minEnd  , I.record_list[i].end);
-		this->maxEnd   = std::max(this->maxEnd  , I.record_list[i].end);
+		this->minStart = std::min(this->minStart, r.start);
+		this->maxStart = std::max(this->maxStart, r.start);
+		this->minEnd   = std::min(this->minEnd  , r.end);
+		this->maxEnd   = std::max(this->maxEnd  , r.end);
 	}
 
 	this->numRecords = till - from + 1;
 }
 
-Relation::~Relation()
+/*
+loads positions [from,till] of a relation sorted by start, without computing its statistics.
+minEnd and maxEnd come from the zone map of the group, so they are bounds if [from,till] is part of a group
+*/
+template <typename T>
+void TemporalRelation<T>::load(const ExtendedRelation& I, size_t from, size_t till, Timestamp minEnd, Timestamp maxEnd)
 {
-	free( this->record_list );
+	this->record_list = (TemporalRecord<T>*) large_malloc( (till - from + 1) * sizeof(TemporalRecord<T>) );
+
+	for (size_t i = from; i <= till; i++)
+		this->record_list[i - from] = TemporalRecord<T>((T) I.getStart(i), (T) I.getEnd(i));
+
+	this->minStart = (T) I.getStart(from);
+	this->maxStart = (T) I.getStart(till);
+	this->minEnd   = (T) minEnd;
+	this->maxEnd   = (T) maxEnd;
+
+	this->numRecords = till - from + 1;
 }
+
+template <typename T>
+TemporalRelation<T>::~TemporalRelation()
+{
+	large_free( this->record_list );
+}
+
+template class TemporalRelation<Timestamp>;
+template class TemporalRelation<ShortTimestamp>;
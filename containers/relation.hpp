@@ -30,12 +30,16 @@
 #define _RELATION_H_
 
 #include "../def.hpp"
+#include "large_alloc.hpp"
+#include <unordered_map>
 
 class ExtendedRelation;
 struct LoadRelationStructure
 {
 	ExtendedRelation* rel;
 	const char* filename;
+	uint32_t numKeys;
+	const bool* stringKeys;		// key columns that hold strings instead of integers
 };
 
 class ExtendedRecord
@@ -43,14 +47,46 @@ class ExtendedRecord
 public:
 	Timestamp start;
 	Timestamp end;
-	uint32_t group1;
-	uint32_t group2;
+	GroupKey key;
 
 	ExtendedRecord();
-	ExtendedRecord(Timestamp start, Timestamp end, uint32_t group1, uint32_t group2);
+	ExtendedRecord(Timestamp start, Timestamp end, GroupKey key);
 	~ExtendedRecord();
 };
 
+template <typename T>
+class TemporalRecord
+{
+public:
+	T start;
+	T end;
+
+	TemporalRecord();
+	TemporalRecord(T start, T end);
+	bool operator < (const TemporalRecord& rhs) const;
+	bool operator >= (const TemporalRecord& rhs) const;
+	~TemporalRecord();
+};
+
+typedef TemporalRecord<Timestamp> Record;
+typedef TemporalRecord<ShortTimestamp> ShortRecord;
+
+/* layout of tuples after sorting - non-temporal values are kept only in Borders if COMPACT_RECORDS is set */
+#ifdef COMPACT_RECORDS
+typedef Record SortedRecord;
+#else
+typedef ExtendedRecord SortedRecord;
+#endif
+
+inline SortedRecord makeSortedRecord(Timestamp start, Timestamp end, [[maybe_unused]] GroupKey key)
+{
+#ifdef COMPACT_RECORDS
+	return Record(start, end);
+#else
+	return ExtendedRecord(start, end, key);
+#endif
+}
+
 class ExtendedRelation
 {
 public:
@@ -58,13 +94,58 @@ public:
 	size_t numRecords;
 	Timestamp minStart, maxEnd;
 
+	// tuples after sorting and finding borders, addressed through Borders - same memory as record_list unless COMPACT_RECORDS is set
+	SortedRecord* sorted_list;
+#ifdef SOA_RECORDS
+	// start and end columns of the tuples after sorting, kept instead of sorted_list
+	Timestamp* sorted_start;
+	Timestamp* sorted_end;
+#endif
+
+	// non-temporal values as read from the input, numKeys per tuple - freed once packed in record_list[i].key
+	uint32_t* key_columns;
+	uint32_t numKeys;
+
+	// ids given to the strings of each string key column while loading - local to the relation until encoded for both relations
+	std::unordered_map<std::string, uint32_t> local_dictionary[MAX_KEY_COLUMNS];
+	bool stringKeys[MAX_KEY_COLUMNS];
+
 	ExtendedRelation();
-	void load(const char *filename);
+	void load(const char *filename, uint32_t numKeys, const bool* stringKeys);
+	void allocateSorted(size_t numRecords);
+
+	// access to the tuples after sorting, in the layout selected in def.hpp
+	inline Timestamp getStart(size_t i) const
+	{
+#ifdef SOA_RECORDS
+		return this->sorted_start[i];
+#else
+		return this->sorted_list[i].start;
+#endif
+	}
+	inline Timestamp getEnd(size_t i) const
+	{
+#ifdef SOA_RECORDS
+		return this->sorted_end[i];
+#else
+		return this->sorted_list[i].end;
+#endif
+	}
+	inline void setSorted(size_t i, Timestamp start, Timestamp end, [[maybe_unused]] GroupKey key)
+	{
+#ifdef SOA_RECORDS
+		this->sorted_start[i] = start;
+		this->sorted_end[i] = end;
+#else
+		this->sorted_list[i] = makeSortedRecord(start, end, key);
+#endif
+	}
+
 	static void *load_helper(void* args)
 	{
 		LoadRelationStructure *gained = (LoadRelationStructure*) args;
 
-		gained->rel->load(gained->filename);
+		gained->rel->load(gained->filename, gained->numKeys, gained->stringKeys);
 
 		return NULL;
 	}
@@ -73,31 +154,23 @@ public:
 
 /**************************************************************************************************/
 
-class Record
-{
-public:
-	Timestamp start;
-	Timestamp end;
-
-	Record();
-	Record(Timestamp start, Timestamp end);
-	bool operator < (const Record& rhs) const;
-	bool operator >= (const Record& rhs) const;
-	~Record();
-};
-
-class Relation
+/* a group (or part of it) loaded for the join kernels, with timestamps of type T */
+template <typename T>
+class TemporalRelation
 {
 public:
-	Record* record_list;
+	TemporalRecord<T>* record_list;
 	size_t numRecords;
-	Timestamp minStart, maxStart, minEnd, maxEnd;
+	T minStart, maxStart, minEnd, maxEnd;
 
-	Relation();
+	TemporalRelation();
 	void load(const ExtendedRelation& I, size_t from, size_t till);
-	~Relation();
+	void load(const ExtendedRelation& I, size_t from, size_t till, Timestamp minEnd, Timestamp maxEnd);
+	~TemporalRelation();
 };
 
+typedef TemporalRelation<Timestamp> Relation;
+typedef TemporalRelation<ShortTimestamp> ShortRelation;
 typedef Relation Group;
 
 #endif //_RELATION_H_
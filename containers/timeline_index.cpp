@@ -0,0 +1,184 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#include "timeline_index.hpp"
+
+template <typename T>
+TimelineEvent<T>::TimelineEvent()
+{
+}
+
+template <typename T>
+TimelineEvent<T>::TimelineEvent(T time, Position tuple, uint32_t kind)
+{
+	this->time = time;
+	this->code = (tuple << 2) | kind;
+}
+
+template <typename T>
+bool TimelineEvent<T>::operator < (const TimelineEvent<T>& rhs) const
+{
+	if (this->time != rhs.time)
+		return this->time < rhs.time;
+	else
+		return (this->code & 3) < (rhs.code & 3);
+}
+
+template <typename T>
+TimelineEvent<T>::~TimelineEvent()
+{
+}
+
+/**************************************************************************************************/
+
+template <typename T>
+TimelineActiveSet<T>::TimelineActiveSet()
+{
+	this->starts = NULL;
+	this->tuples = NULL;
+	this->slot = NULL;
+	this->size = 0;
+}
+
+template <typename T>
+void TimelineActiveSet<T>::init(size_t numRecords)
+{
+	this->starts = (T*) malloc( numRecords * sizeof(T) );
+	this->tuples = (Position*) malloc( numRecords * sizeof(Position) );
+	this->slot = (Position*) malloc( numRecords * sizeof(Position) );
+	this->size = 0;
+}
+
+template <typename T>
+TimelineActiveSet<T>::~TimelineActiveSet()
+{
+	free( this->starts );
+	free( this->tuples );
+	free( this->slot );
+}
+
+/**************************************************************************************************/
+
+template <typename T>
+bool eventBefore(const TimelineEvent<T>& e, T t)
+{
+	return e.time < t;
+}
+
+template <typename T>
+TemporalTimelineIndex<T>::TemporalTimelineIndex()
+{
+	this->event_list = NULL;
+	this->numEvents = 0;
+}
+
+/*
+Builds the index over R, with at least minDistance events between checkpoints.
+Tuples that don't end after their start only get a point event at their start
+*/
+template <typename T>
+void TemporalTimelineIndex<T>::build(const TemporalRelation<T> &R, size_t minDistance)
+{
+	this->event_list = (TimelineEvent<T>*) malloc( 2 * R.numRecords * sizeof(TimelineEvent<T>) );
+	this->numEvents = 0;
+	for (size_t i = 0; i < R.numRecords; i++)
+	{
+		if (R.record_list[i].end <= R.record_list[i].start)
+		{
+			this->event_list[ this->numEvents++ ] = TimelineEvent<T>( R.record_list[i].start, i, TIMELINE_POINT);
+			continue;
+		}
+		this->event_list[ this->numEvents++ ] = TimelineEvent<T>( R.record_list[i].start, i, TIMELINE_START);
+		this->event_list[ this->numEvents++ ] = TimelineEvent<T>( R.record_list[i].end, i, TIMELINE_END);
+	}
+	std::sort( this->event_list, this->event_list + this->numEvents);
+
+	// replay the timeline, taking checkpoints on the way
+	TimelineActiveSet<T> active;
+	active.init( R.numRecords);
+	size_t previous = 0;
+	for (size_t e = 0; e < this->numEvents; e++)
+	{
+		if ( (e == 0) || (e - previous >= std::max(minDistance, active.size)) )
+		{
+			this->checkpoint_events.push_back(e);
+			this->checkpoint_offsets.push_back( this->checkpoint_tuples.size() );
+			this->checkpoint_tuples.insert( this->checkpoint_tuples.end(), active.tuples, active.tuples + active.size);
+			previous = e;
+		}
+
+		Position tuple = this->event_list[e].code >> 2;
+		if ( (this->event_list[e].code & 3) == TIMELINE_START )
+			active.insert( tuple, R.record_list[tuple].start);
+		else if ( (this->event_list[e].code & 3) == TIMELINE_END )
+			active.erase( tuple);
+	}
+	this->checkpoint_offsets.push_back( this->checkpoint_tuples.size() );
+}
+
+/*
+Moves to the first event at or after from: fills active (initialized for R) with the tuples active before that event and returns it.
+Starts from the last checkpoint before the event, so only the events after the checkpoint are replayed
+*/
+template <typename T>
+size_t TemporalTimelineIndex<T>::seek(const TemporalRelation<T> &R, T from, TimelineActiveSet<T> &active) const
+{
+	active.size = 0;
+	if (this->numEvents == 0)
+		return 0;
+
+	size_t e = std::lower_bound( this->event_list, this->event_list + this->numEvents, from, eventBefore<T>) - this->event_list;
+	size_t c = std::upper_bound( this->checkpoint_events.begin(), this->checkpoint_events.end(), e) - this->checkpoint_events.begin() - 1;
+
+	for (size_t i = this->checkpoint_offsets[c]; i < this->checkpoint_offsets[c+1]; i++)
+		active.insert( this->checkpoint_tuples[i], R.record_list[ this->checkpoint_tuples[i] ].start);
+	for (size_t i = this->checkpoint_events[c]; i < e; i++)
+	{
+		Position tuple = this->event_list[i].code >> 2;
+		if ( (this->event_list[i].code & 3) == TIMELINE_START )
+			active.insert( tuple, R.record_list[tuple].start);
+		else if ( (this->event_list[i].code & 3) == TIMELINE_END )
+			active.erase( tuple);
+	}
+
+	return e;
+}
+
+template <typename T>
+TemporalTimelineIndex<T>::~TemporalTimelineIndex()
+{
+	free( this->event_list );
+}
+
+template class TimelineEvent<Timestamp>;
+template class TimelineEvent<ShortTimestamp>;
+template class TimelineActiveSet<Timestamp>;
+template class TimelineActiveSet<ShortTimestamp>;
+template class TemporalTimelineIndex<Timestamp>;
+template class TemporalTimelineIndex<ShortTimestamp>;
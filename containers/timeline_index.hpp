@@ -0,0 +1,110 @@
+/******************************************************************************
+ * Project:  temporal_joins
+ * Purpose:  Compute temporal joins with conjunctive equality predicates
+ * Author:   Ioannis Reppas, giannisreppas@hotmail.com
+ ******************************************************************************
+ * Copyright (c) 2023, Ioannis Reppas
+ *
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ******************************************************************************/
+
+
+#ifndef _TIMELINE_INDEX_H_
+#define _TIMELINE_INDEX_H_
+
+#include "../def.hpp"
+#include "relation.hpp"
+
+/* kinds of events, in their order at the same time */
+#define TIMELINE_END 0		// end of a tuple
+#define TIMELINE_POINT 1	// zero-length tuple, never active
+#define TIMELINE_START 2	// start of a tuple
+
+/* event of a tuple of a group - code is the position of the tuple in the group, shifted left, with its kind in the lowest two bits */
+template <typename T>
+class TimelineEvent
+{
+public:
+	T time;
+	Position code;
+
+	TimelineEvent();
+	TimelineEvent(T time, Position tuple, uint32_t kind);
+	bool operator < (const TimelineEvent& rhs) const;
+	~TimelineEvent();
+};
+
+/* tuples of a group that are active at a point of its timeline - insert and erase in O(1), without gaps */
+template <typename T>
+class TimelineActiveSet
+{
+public:
+	T* starts;				// start points of the active tuples, in no order
+	Position* tuples;		// positions of the active tuples in the group
+	Position* slot;			// slot of each tuple of the group in starts and tuples
+	size_t size;
+
+	TimelineActiveSet();
+	void init(size_t numRecords);
+	inline void insert(Position tuple, T start)
+	{
+		this->starts[this->size] = start;
+		this->tuples[this->size] = tuple;
+		this->slot[tuple] = this->size++;
+	}
+	inline void erase(Position tuple)
+	{
+		Position s = this->slot[tuple];
+		this->size--;
+		this->starts[s] = this->starts[this->size];
+		this->tuples[s] = this->tuples[this->size];
+		this->slot[ this->tuples[s] ] = s;
+	}
+	~TimelineActiveSet();
+};
+
+/*
+Timeline index of a group: its start and end events sorted by time, ends before starts at the same time,
+and a single event for each zero-length tuple, between the ends and the starts of its time,
+with checkpoints of the tuples active before some of the events.
+A checkpoint is taken once at least as many events as its active tuples have passed since the previous one,
+so that checkpoints never take more space than the events
+*/
+template <typename T>
+class TemporalTimelineIndex
+{
+public:
+	TimelineEvent<T>* event_list;
+	size_t numEvents;
+
+	std::vector<size_t> checkpoint_events;		// event each checkpoint is taken before
+	std::vector<size_t> checkpoint_offsets;		// first tuple of each checkpoint in checkpoint_tuples, one more for the end
+	std::vector<Position> checkpoint_tuples;
+
+	TemporalTimelineIndex();
+	void build(const TemporalRelation<T> &R, size_t minDistance);
+	size_t seek(const TemporalRelation<T> &R, T from, TimelineActiveSet<T> &active) const;
+	~TemporalTimelineIndex();
+};
+
+typedef TemporalTimelineIndex<Timestamp> TimelineIndex;
+
+#endif //_TIMELINE_INDEX_H_
@@ -46,6 +46,17 @@
 #define TIMES
 //#define WORKLOAD_COUNT
 
+/* MEMORY PARAMETERS */
+#define COMPACT_RECORDS
+//#define SOA_RECORDS
+#define HUGE_PAGES
+#define HUGE_PAGE_SIZE (2*1024*1024)
+//#define SHORT_POSITIONS
+#define SHORT_TIMESTAMPS
+
+/* THREAD PARAMETERS */
+#define NUMA_AWARE
+
 /* JOIN TYPES */
 #define INNER_JOIN 0
 #define LEFT_OUTER_JOIN 1
@@ -57,9 +68,44 @@
 #define BGU_FS 0
 #define DIP 1
 #define O_DIP 2
+#define HINT 3
+#define TIMELINE 4
+#define OIP 5
+#define EBI 6
+#define BG_FS 7
+#define PLAIN_FS 8
+#define AUTO_FS 9
+#define PLANNER 10
+#define NESTED_LOOP 11
+#define FLAT_FS 12
+#define SPLIT_FS 13
+#define LEARNED_FS 14
+
+/* forward scans join group pairs with fewer tuples than this on both sides by comparing all pairs */
+#define TINY_GROUP 64
+
+/* POLICIES TO PIN THREADS TO CPUS */
+#define PLACEMENT_NONE 0
+#define PLACEMENT_COMPACT 1
+#define PLACEMENT_SCATTER 2
+#define PLACEMENT_PHYSICAL 3
 
 typedef unsigned long long Timestamp;
 
+/* timestamps used by the join kernels, if all timestamps of the inputs fit (see SHORT_TIMESTAMPS) */
+typedef uint32_t ShortTimestamp;
+
+/* positions of tuples in a relation - SHORT_POSITIONS limits relations to 4294967295 tuples */
+#ifdef SHORT_POSITIONS
+typedef uint32_t Position;
+#else
+typedef uint64_t Position;
+#endif
+
+/* non-temporal values of a tuple, packed in one integer so that groups are compared with a single comparison */
+typedef uint64_t GroupKey;
+#define MAX_KEY_COLUMNS 5
+
 class Timer
 {
 private:
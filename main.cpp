@@ -29,22 +29,65 @@
 #include "getopt.h"
 #include "def.hpp"
 #include "containers/borders.hpp"
+#include "containers/group_directory.hpp"
 #include "containers/relation.hpp"
 #include "containers/bucket_index.hpp"
+#include "containers/learned_index.hpp"
+#include "containers/hint_index.hpp"
+#include "containers/timeline_index.hpp"
+#include "containers/oip_grid.hpp"
+#include "containers/large_alloc.hpp"
+#include "containers/placement.hpp"
+
+// groupKeys
+void mainEncodeKeys( ExtendedRelation& R, ExtendedRelation& S, ThreadPlacement& placement, uint32_t c);
+void mainPackKeys( ExtendedRelation& R, ExtendedRelation& S, ThreadPlacement& placement, uint32_t c);
+
+// semiJoin
+void mainSemiJoin( ExtendedRelation& R, ExtendedRelation& S, bool filterR, bool filterS, ThreadPlacement& placement, uint32_t c);
 
 // findBorders
-void mainBorders( ExtendedRelation& R, Borders& bordersR, ExtendedRelation& S, Borders& bordersS, uint32_t c);
+void mainBorders( ExtendedRelation& R, Borders& bordersR, ExtendedRelation& S, Borders& bordersS, ThreadPlacement& placement, uint32_t c);
+
+// matchBorders
+void mainGroupDirectory( Borders& bordersR, Borders& bordersS, GroupDirectory& directory, ThreadPlacement& placement, uint32_t c);
+
+// compact
+void mainCompact( ExtendedRelation& R, ExtendedRelation& S, ThreadPlacement& placement, uint32_t c);
 
 // complement
-void convert_to_complement( ExtendedRelation& R, Borders& borders, ExtendedRelation& complement, Borders& borders_complement, Timestamp foreignStart, Timestamp foreignEnd, uint32_t runNumThreads);
+void convert_to_complement( ExtendedRelation& R, Borders& borders, ExtendedRelation& complement, Borders& borders_complement, Timestamp foreignStart, Timestamp foreignEnd, ThreadPlacement& placement, uint32_t runNumThreads);
 
 // bguFS
-uint64_t bguFS(Relation &R, Relation &S, BucketIndex &BIR, BucketIndex &BIS);
+template <typename T> uint64_t bguFS(TemporalRelation<T> &R, TemporalRelation<T> &S, TemporalBucketIndex<T> &BIR, TemporalBucketIndex<T> &BIS);
+template <typename T> uint64_t bguFS(TemporalRelation<T> &R, TemporalRelation<T> &S, TemporalLearnedIndex<T> &LIR, TemporalLearnedIndex<T> &LIS);
+template <typename T> uint64_t bgFS(TemporalRelation<T> &R, TemporalRelation<T> &S, TemporalBucketIndex<T> &BIR, TemporalBucketIndex<T> &BIS);
+template <typename T> uint64_t FS(TemporalRelation<T> &R, TemporalRelation<T> &S);
+template <typename T> int fs_variant(const TemporalRelation<T> &R, const TemporalRelation<T> &S);
 
 // dip algorithms
-uint64_t dip_anti(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd);
-uint64_t o_dip_anti(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd);
-uint64_t dip_inner(Relation& R, Relation& S, Timestamp& domainStart, Timestamp& domainEnd);
+template <typename T> uint64_t dip_anti(TemporalRelation<T>& R, TemporalRelation<T>& S, T& domainStart, T& domainEnd);
+template <typename T> uint64_t o_dip_anti(TemporalRelation<T>& R, TemporalRelation<T>& S, T& domainStart, T& domainEnd);
+template <typename T> uint64_t dip_inner(TemporalRelation<T>& R, TemporalRelation<T>& S, T& domainStart, T& domainEnd);
+
+// hint
+template <typename T> uint64_t hint_join(TemporalRelation<T> &R, TemporalHintIndex<T> &HS);
+
+// timeline
+template <typename T> uint64_t timeline_join(TemporalRelation<T> &R, TemporalTimelineIndex<T> &TR, TemporalRelation<T> &S, TemporalTimelineIndex<T> &TS);
+
+// oip
+template <typename T> uint64_t oip_join(TemporalOipGrid<T> &GR, TemporalOipGrid<T> &GS, uint32_t part, uint32_t numParts);
+
+// ebi
+template <typename T> uint64_t ebi_join(TemporalRelation<T> &R, TemporalRelation<T> &S);
+
+// nested loop
+template <typename T> uint64_t nested_loop(TemporalRelation<T> &R, TemporalRelation<T> &S);
+
+// long and short tuples
+template <typename T> bool split_by_length(const TemporalRelation<T>& R, T threshold, TemporalRelation<T>& Short, TemporalRelation<T>& Long);
+template <typename T> uint64_t long_short_join(const TemporalRelation<T>& Long, const TemporalRelation<T>& Short, T threshold);
 
 // used to get the id of an available thread
 uint32_t getThreadId(bool& needsDetach, uint32_t* jobsList, uint32_t& jobsListSize);
@@ -54,10 +97,8 @@ uint32_t getThreadId(bool& needsDetach, uint32_t* jobsList, uint32_t& jobsListSi
 /* function defining sorting of ExtendedRelation */
 bool sortByGroupAndStartPoint( ExtendedRecord a, ExtendedRecord b)
 {
-	if (a.group1 != b.group1)
-		return a.group1 < b.group1;
-	else if (a.group2 != b.group2)
-		return a.group2 < b.group2;
+	if (a.key != b.key)
+		return a.key < b.key;
 	else
 		return a.start < b.start;
 }
@@ -66,10 +107,12 @@ struct structForParallelFS
 {
 	ExtendedRelation* exR;					// relation R with non-temporal values
 	ExtendedRelation* exS;					// relation S with non-temporal values
-	uint32_t R_start;					// start position to run bguFS from exR
-	uint32_t R_end;						// end position to run bguFS from exR
-	uint32_t S_start;					// start position to run bguFS from exS
-	uint32_t S_end;						// end position to run bguFS from exS
+	Position R_start;					// start position to run bguFS from exR
+	Position R_end;						// end position to run bguFS from exR
+	Position S_start;					// start position to run bguFS from exS
+	Position S_end;						// end position to run bguFS from exS
+	BordersElement* groupR;				// zone map of the group of exR
+	BordersElement* groupS;				// zone map of the group of exS
 
 	uint32_t threadId;						// thread id
 	uint64_t* thread_results;	// array that keeps the results of each thread
@@ -78,33 +121,296 @@ struct structForParallelFS
 	/* required only for DIP - bguFS computes always inner join so it doesn't need them */
 	Timestamp domainStart;
 	Timestamp domainEnd;
+
+	/* required only for OIP - a group is joined by numParts tasks, each joining part of its partition pairs */
+	uint32_t part;
+	uint32_t numParts;
+	void* oipGroup;						// OipGroup shared by the tasks of the group
+
+	/* required only for outer-only batches - groups of exR without a counterpart in exS */
+	Borders* bordersR;					// border information for exR
+	uint32_t borders_start;				// first group of the batch in bordersR
+	uint32_t borders_end;				// last group of the batch in bordersR
+
+	/* required only for flat scans - groups [directory_start,directory_end) of the directory joined in one pass */
+	Borders* bordersS;					// border information for exS
+	uint32_t* groupOfR;					// groups of exR in the directory
+	uint32_t* groupOfS;					// groups of exS in the directory
+	uint32_t directory_start;
+	uint32_t directory_end;
+	uint32_t shift;						// bits of the timestamps, above which each group is placed on one timeline
 };
 
+bool startBefore(const SortedRecord& r, Timestamp t)
+{
+	return r.start < t;
+}
+
+/*
+Returns the last position in [from,till] of a group sorted by start point, whose start point is before bound.
+Tuples after it can't overlap with a group that ends at bound.
+*/
+Position trim_group(const ExtendedRelation& I, Position from, Position till, Timestamp bound)
+{
+#ifdef SOA_RECORDS
+	Timestamp* first = I.sorted_start + from;
+	Timestamp* last = I.sorted_start + till + 1;
+	Timestamp* pos = std::lower_bound( first, last, bound);
+#else
+	SortedRecord* first = I.sorted_list + from;
+	SortedRecord* last = I.sorted_list + till + 1;
+	SortedRecord* pos = std::lower_bound( first, last, bound, startBefore);
+#endif
+
+	return from + (pos - first) - 1;
+}
+
+/*
+Loads the parts of a group pair that can overlap, using the zone maps of the pair.
+Used by algorithms that compute overlaps only, since both groups are trimmed to their common window
+*/
+template <typename T>
+void load_overlapping_window(structForParallelFS* gained, TemporalRelation<T>& R, TemporalRelation<T>& S)
+{
+	Position R_end = trim_group( *(gained->exR), gained->R_start, gained->R_end, gained->groupS->maxEnd);
+	Position S_end = trim_group( *(gained->exS), gained->S_start, gained->S_end, gained->groupR->maxEnd);
+
+	R.load( *(gained->exR), gained->R_start, R_end, gained->groupR->minEnd, gained->groupR->maxEnd);
+	S.load( *(gained->exS), gained->S_start, S_end, gained->groupS->minEnd, gained->groupS->maxEnd);
+}
+
+/*
+Forward scan of a group pair - variant is BGU_FS, BG_FS, PLAIN_FS, or AUTO_FS to pick one of them for each pair,
+or LEARNED_FS for bguFS with learned indexes instead of buckets.
+bguFS and auto compare all pairs of tiny pairs instead, since sorting and bucket indexes cost more than the comparisons
+*/
+template <typename T, int variant = BGU_FS>
 void* worker_bguFS(void* args)
 {
 	structForParallelFS *gained = (structForParallelFS*) args;
 
-	Relation R;
-	R.numRecords = 0;
-	R.minStart = std::numeric_limits<Timestamp>::max();
-	R.maxStart = std::numeric_limits<Timestamp>::min();
-	R.minEnd   = std::numeric_limits<Timestamp>::max();
-	R.maxEnd   = std::numeric_limits<Timestamp>::min();
-	R.load( *(gained->exR), gained->R_start, gained->R_end);
+	TemporalRelation<T> R, S;
+	load_overlapping_window(gained, R, S);
 
-	Relation S;
-	S.numRecords = 0;
-	S.minStart = std::numeric_limits<Timestamp>::max();
-	S.maxStart = std::numeric_limits<Timestamp>::min();
-	S.minEnd   = std::numeric_limits<Timestamp>::max();
-	S.maxEnd   = std::numeric_limits<Timestamp>::min();
-	S.load( *(gained->exS), gained->S_start, gained->S_end);
+	bool tiny = (R.numRecords < TINY_GROUP) && (S.numRecords < TINY_GROUP);
+	int fs = (variant == AUTO_FS) ? fs_variant(R, S) : variant;
+	if ( tiny && ( (variant == BGU_FS) || (variant == AUTO_FS) ) )
+	{
+		gained->thread_results[ gained->threadId ] += nested_loop(R, S);
+	}
+	else if (fs == PLAIN_FS)
+	{
+		gained->thread_results[ gained->threadId ] += FS(R, S);
+	}
+	else if (fs == LEARNED_FS)
+	{
+		TemporalLearnedIndex<T> LIR, LIS;
+		LIR.build(R, 32);
+		LIS.build(S, 32);
+
+		gained->thread_results[ gained->threadId ] += bguFS(R, S, LIR, LIS);
+	}
+	else
+	{
+		TemporalBucketIndex<T> BIR, BIS;
+		BIR.build(R, 1000);
+		BIS.build(S, 1000);
+
+		if (fs == BG_FS)
+			gained->thread_results[ gained->threadId ] += bgFS(R, S, BIR, BIS);
+		else
+			gained->thread_results[ gained->threadId ] += bguFS(R, S, BIR, BIS);
+	}
+
+	// make current thread free to be used for next group
+	gained->jobsList[ gained->threadId ] = 2;
+
+	return NULL;
+}
+
+template <typename T>
+void* worker_hint(void* args)
+{
+	structForParallelFS *gained = (structForParallelFS*) args;
+
+	TemporalRelation<T> R, S;
+	load_overlapping_window(gained, R, S);
+
+	TemporalHintIndex<T> HS;
+	HS.build(S, 16);
+
+	gained->thread_results[ gained->threadId ] += hint_join(R, HS);
+
+	// make current thread free to be used for next group
+	gained->jobsList[ gained->threadId ] = 2;
+
+	return NULL;
+}
+
+template <typename T>
+void* worker_timeline(void* args)
+{
+	structForParallelFS *gained = (structForParallelFS*) args;
+
+	TemporalRelation<T> R, S;
+	load_overlapping_window(gained, R, S);
+
+	TemporalTimelineIndex<T> TR, TS;
+	TR.build(R, 1024);
+	TS.build(S, 1024);
+
+	gained->thread_results[ gained->threadId ] += timeline_join(R, TR, S, TS);
+
+	// make current thread free to be used for next group
+	gained->jobsList[ gained->threadId ] = 2;
+
+	return NULL;
+}
+
+/* grids of a group pair joined by numParts OIP tasks - built by the first task that runs, freed by the last one that finishes */
+template <typename T>
+struct OipGroup
+{
+	pthread_mutex_t lock;
+	bool built;
+	uint32_t remaining;
+	TemporalOipGrid<T> GR, GS;
+
+	OipGroup(uint32_t numParts)
+	{
+		pthread_mutex_init( &this->lock, NULL);
+		this->built = false;
+		this->remaining = numParts;
+	}
+	~OipGroup()
+	{
+		pthread_mutex_destroy( &this->lock);
+	}
+};
+
+template <typename T>
+void* worker_oip(void* args)
+{
+	structForParallelFS *gained = (structForParallelFS*) args;
+	OipGroup<T>* group = (OipGroup<T>*) gained->oipGroup;
+
+	pthread_mutex_lock( &group->lock);
+	if (!group->built)
+	{
+		TemporalRelation<T> R, S;
+		load_overlapping_window(gained, R, S);
+
+		// granules over the common domain of the pair, about sqrt(n)/2 so that partitions hold a few tuples each
+		uint32_t numGranules = (uint32_t) sqrt( (double) (R.numRecords + S.numRecords) / 4) + 1;
+		T base = std::min(R.minStart, S.minStart);
+		T last = std::max( std::max(R.maxEnd, S.maxEnd) - 1, base);
+		group->GR.build(R, base, last, numGranules);
+		group->GS.build(S, base, last, numGranules);
+		group->built = true;
+	}
+	pthread_mutex_unlock( &group->lock);
+
+	gained->thread_results[ gained->threadId ] += oip_join(group->GR, group->GS, gained->part, gained->numParts);
+
+	pthread_mutex_lock( &group->lock);
+	bool lastTask = (--group->remaining == 0);
+	pthread_mutex_unlock( &group->lock);
+	if (lastTask)
+		delete group;
+
+	// make current thread free to be used for next group
+	gained->jobsList[ gained->threadId ] = 2;
+
+	return NULL;
+}
+
+template <typename T>
+void* worker_ebi(void* args)
+{
+	structForParallelFS *gained = (structForParallelFS*) args;
+
+	TemporalRelation<T> R, S;
+	load_overlapping_window(gained, R, S);
+
+	gained->thread_results[ gained->threadId ] += ebi_join(R, S);
+
+	// make current thread free to be used for next group
+	gained->jobsList[ gained->threadId ] = 2;
+
+	return NULL;
+}
+
+template <typename T>
+void* worker_nested_loop(void* args)
+{
+	structForParallelFS *gained = (structForParallelFS*) args;
+
+	TemporalRelation<T> R, S;
+	load_overlapping_window(gained, R, S);
+
+	gained->thread_results[ gained->threadId ] += nested_loop(R, S);
+
+	// make current thread free to be used for next group
+	gained->jobsList[ gained->threadId ] = 2;
+
+	return NULL;
+}
 
-	BucketIndex BIR, BIS;
+/* bguFS of a group pair, or the nested loop if the pair is tiny */
+template <typename T>
+uint64_t short_join(TemporalRelation<T>& R, TemporalRelation<T>& S)
+{
+	if ( (R.numRecords == 0) || (S.numRecords == 0) )
+		return 0;
+	if ( (R.numRecords < TINY_GROUP) && (S.numRecords < TINY_GROUP) )
+		return nested_loop(R, S);
+
+	TemporalBucketIndex<T> BIR, BIS;
 	BIR.build(R, 1000);
 	BIS.build(S, 1000);
+	return bguFS(R, S, BIR, BIS);
+}
+
+/*
+Splits both groups of a pair in short and long tuples, by four times the average length of the pair.
+Short tuples are joined with bguFS, so that a few long tuples don't make its runs of pivots degenerate,
+long ones with the short tuples of the other group that start close enough to overlap them, and with each other in a nested loop
+*/
+template <typename T>
+void* worker_split(void* args)
+{
+	structForParallelFS *gained = (structForParallelFS*) args;
+
+	TemporalRelation<T> R, S;
+	load_overlapping_window(gained, R, S);
+
+	double numRecords = (gained->groupR->position_end - gained->groupR->position_start + 1) + (gained->groupS->position_end - gained->groupS->position_start + 1);
+	double average = (gained->groupR->sumLength + gained->groupS->sumLength) / numRecords;
+	T threshold = (T) std::min( std::max(4 * average, 1.0), (double) std::numeric_limits<T>::max());
 
-	gained->thread_results[ gained->threadId ] += bguFS(R, S, BIR, BIS);
+	TemporalRelation<T> shortR, longR, shortS, longS;
+	bool splitR = split_by_length(R, threshold, shortR, longR);
+	bool splitS = split_by_length(S, threshold, shortS, longS);
+
+	uint64_t result;
+	if (!splitR && !splitS)
+	{
+		result = short_join(R, S);
+	}
+	else if (!splitR)
+	{
+		result = short_join(R, shortS) + long_short_join(longS, R, threshold);
+	}
+	else if (!splitS)
+	{
+		result = short_join(shortR, S) + long_short_join(longR, S, threshold);
+	}
+	else
+	{
+		result = short_join(shortR, shortS) + long_short_join(longR, shortS, threshold) + long_short_join(longS, shortR, threshold)
+				+ nested_loop(longR, longS);
+	}
+	gained->thread_results[ gained->threadId ] += result;
 
 	// make current thread free to be used for next group
 	gained->jobsList[ gained->threadId ] = 2;
@@ -112,27 +418,30 @@ void* worker_bguFS(void* args)
 	return NULL;
 }
 
+template <typename T>
 void* worker_dip_anti(void* args)
 {
 	structForParallelFS *gained = (structForParallelFS*) args;
 
-	Relation R;
+	TemporalRelation<T> R;
 	R.numRecords = 0;
-	R.minStart = std::numeric_limits<Timestamp>::max();
-	R.maxStart = std::numeric_limits<Timestamp>::min();
-	R.minEnd   = std::numeric_limits<Timestamp>::max();
-	R.maxEnd   = std::numeric_limits<Timestamp>::min();
+	R.minStart = std::numeric_limits<T>::max();
+	R.maxStart = std::numeric_limits<T>::min();
+	R.minEnd   = std::numeric_limits<T>::max();
+	R.maxEnd   = std::numeric_limits<T>::min();
 	R.load( *(gained->exR), gained->R_start, gained->R_end);
 
-	Relation S;
+	TemporalRelation<T> S;
 	S.numRecords = 0;
-	S.minStart = std::numeric_limits<Timestamp>::max();
-	S.maxStart = std::numeric_limits<Timestamp>::min();
-	S.minEnd   = std::numeric_limits<Timestamp>::max();
-	S.maxEnd   = std::numeric_limits<Timestamp>::min();
+	S.minStart = std::numeric_limits<T>::max();
+	S.maxStart = std::numeric_limits<T>::min();
+	S.minEnd   = std::numeric_limits<T>::max();
+	S.maxEnd   = std::numeric_limits<T>::min();
 	S.load( *(gained->exS), gained->S_start, gained->S_end);
 
-	gained->thread_results[ gained->threadId ] += dip_anti(R, S, gained->domainStart, gained->domainEnd);
+	T domainStart = (T) gained->domainStart;
+	T domainEnd = (T) gained->domainEnd;
+	gained->thread_results[ gained->threadId ] += dip_anti(R, S, domainStart, domainEnd);
 
 	// make current thread free to be used for next group
 	gained->jobsList[ gained->threadId ] = 2;
@@ -140,27 +449,17 @@ void* worker_dip_anti(void* args)
 	return NULL;
 }
 
+template <typename T>
 void* worker_dip_inner(void* args)
 {
 	structForParallelFS *gained = (structForParallelFS*) args;
 
-	Relation R;
-	R.numRecords = 0;
-	R.minStart = std::numeric_limits<Timestamp>::max();
-	R.maxStart = std::numeric_limits<Timestamp>::min();
-	R.minEnd   = std::numeric_limits<Timestamp>::max();
-	R.maxEnd   = std::numeric_limits<Timestamp>::min();
-	R.load( *(gained->exR), gained->R_start, gained->R_end);
-
-	Relation S;
-	S.numRecords = 0;
-	S.minStart = std::numeric_limits<Timestamp>::max();
-	S.maxStart = std::numeric_limits<Timestamp>::min();
-	S.minEnd   = std::numeric_limits<Timestamp>::max();
-	S.maxEnd   = std::numeric_limits<Timestamp>::min();
-	S.load( *(gained->exS), gained->S_start, gained->S_end);
+	TemporalRelation<T> R, S;
+	load_overlapping_window(gained, R, S);
 
-	gained->thread_results[ gained->threadId ] += dip_inner(R, S, gained->domainStart, gained->domainEnd);
+	T domainStart = (T) gained->domainStart;
+	T domainEnd = (T) gained->domainEnd;
+	gained->thread_results[ gained->threadId ] += dip_inner(R, S, domainStart, domainEnd);
 
 	// make current thread free to be used for next group
 	gained->jobsList[ gained->threadId ] = 2;
@@ -168,27 +467,30 @@ void* worker_dip_inner(void* args)
 	return NULL;
 }
 
+template <typename T>
 void* worker_o_dip_anti(void* args)
 {
 	structForParallelFS *gained = (structForParallelFS*) args;
 
-	Relation R;
+	TemporalRelation<T> R;
 	R.numRecords = 0;
-	R.minStart = std::numeric_limits<Timestamp>::max();
-	R.maxStart = std::numeric_limits<Timestamp>::min();
-	R.minEnd   = std::numeric_limits<Timestamp>::max();
-	R.maxEnd   = std::numeric_limits<Timestamp>::min();
+	R.minStart = std::numeric_limits<T>::max();
+	R.maxStart = std::numeric_limits<T>::min();
+	R.minEnd   = std::numeric_limits<T>::max();
+	R.maxEnd   = std::numeric_limits<T>::min();
 	R.load( *(gained->exR), gained->R_start, gained->R_end);
 
-	Relation S;
+	TemporalRelation<T> S;
 	S.numRecords = 0;
-	S.minStart = std::numeric_limits<Timestamp>::max();
-	S.maxStart = std::numeric_limits<Timestamp>::min();
-	S.minEnd   = std::numeric_limits<Timestamp>::max();
-	S.maxEnd   = std::numeric_limits<Timestamp>::min();
+	S.minStart = std::numeric_limits<T>::max();
+	S.maxStart = std::numeric_limits<T>::min();
+	S.minEnd   = std::numeric_limits<T>::max();
+	S.maxEnd   = std::numeric_limits<T>::min();
 	S.load( *(gained->exS), gained->S_start, gained->S_end);
 
-	gained->thread_results[ gained->threadId ] += o_dip_anti(R, S, gained->domainStart, gained->domainEnd);
+	T domainStart = (T) gained->domainStart;
+	T domainEnd = (T) gained->domainEnd;
+	gained->thread_results[ gained->threadId ] += o_dip_anti(R, S, domainStart, domainEnd);
 
 	// make current thread free to be used for next group
 	gained->jobsList[ gained->threadId ] = 2;
@@ -196,7 +498,236 @@ void* worker_o_dip_anti(void* args)
 	return NULL;
 }
 
-uint64_t extended_temporal_join( ExtendedRelation& exR, Borders& bordersR, ExtendedRelation& exS, Borders& bordersS, uint32_t runNumThreads, int algorithm, bool outerFlag)
+void* worker_outer_only(void* args)
+{
+	structForParallelFS *gained = (structForParallelFS*) args;
+
+	// join between R and time_domain (= R) for every group of the batch
+	uint64_t result = 0;
+	for (uint32_t g = gained->borders_start; g <= gained->borders_end; g++)
+	{
+#ifdef WORKLOAD_COUNT
+		result += gained->bordersR->borders_list[g].position_end - gained->bordersR->borders_list[g].position_start + 1;
+#else
+		for (Position i = gained->bordersR->borders_list[g].position_start; i < gained->bordersR->borders_list[g].position_end ; i++)
+			result += gained->domainStart ^ gained->exR->getStart(i);
+#endif
+	}
+
+	gained->thread_results[ gained->threadId ] += result;
+
+	// make current thread free to be used for next group
+	gained->jobsList[ gained->threadId ] = 2;
+
+	return NULL;
+}
+
+/*
+Hands groups [first,last] of bordersR, which have no counterpart in exS, to an available thread.
+Consecutive unmatched groups are batched by the caller, so that the master thread only schedules.
+*/
+void dispatch_outer_only( ExtendedRelation& exR, Borders& bordersR, uint32_t first, uint32_t last, Timestamp domainStart, ThreadPlacement& placement,
+							structForParallelFS* toPass, pthread_t* threads, uint32_t* jobsList, uint64_t* thread_results, uint32_t runNumThreads)
+{
+	bool needsDetach = false;
+	uint32_t threadId = getThreadId(needsDetach, jobsList, runNumThreads);
+	if (needsDetach)
+		if (pthread_detach(threads[threadId]))
+			printf("Whoops\n");
+
+	toPass[threadId].exR = &exR;
+	toPass[threadId].bordersR = &bordersR;
+	toPass[threadId].borders_start = first;
+	toPass[threadId].borders_end = last;
+
+	toPass[threadId].threadId = threadId;
+	toPass[threadId].jobsList = jobsList;
+	toPass[threadId].thread_results = thread_results;
+
+	toPass[threadId].domainStart = domainStart;
+
+	pthread_create( &threads[threadId], placement.attr(threadId), worker_outer_only, &toPass[threadId]);
+}
+
+/* algorithms that compute overlaps only - they compute outer and anti joins through the complements */
+bool computesOverlapsOnly(int algorithm)
+{
+	return (algorithm == BGU_FS) || (algorithm == HINT) || (algorithm == TIMELINE) || (algorithm == OIP) || (algorithm == EBI)
+			|| (algorithm == BG_FS) || (algorithm == PLAIN_FS) || (algorithm == AUTO_FS) || (algorithm == PLANNER) || (algorithm == FLAT_FS)
+			|| (algorithm == SPLIT_FS) || (algorithm == LEARNED_FS);
+}
+
+/*
+Checks if the join kernels can use 32-bit timestamps for a join whose timestamps are in [minStart,maxEnd].
+All of them need the same upper 32 bits, so that truncating keeps their order and the xor of any two of them,
+and the largest 32-bit value must stay unused, since DIP uses it as null timepoint
+*/
+bool fitsShortTimestamps(Timestamp minStart, Timestamp maxEnd)
+{
+#ifdef SHORT_TIMESTAMPS
+	return (minStart <= maxEnd) && ( (minStart >> 32) == ((maxEnd + 1) >> 32) );
+#else
+	return false;
+#endif
+}
+
+/* group pairs joined by each algorithm the planner picks, in the current computation */
+uint64_t plannedGroups[NESTED_LOOP+1];
+
+/*
+Picks the algorithm to join a group pair with, from the sizes, zone maps and sums of lengths of the pair, in comparisons:
+	nested loop --> compares all pairs without building anything, four pairs at a time in vectors
+	bguFS       --> sorts the groups it gathers by end and builds two bucket indexes, then scans each tuple once
+	DIP         --> builds disjoint partitions of both groups, about as many as the tuples active at a time,
+					then merges every partition of S with all of R, visiting all partitions of R for each tuple of S
+Results are the same for all of them, so they are left out of the costs
+*/
+int plan_group(const BordersElement& groupR, const BordersElement& groupS)
+{
+	double nR = groupR.position_end - groupR.position_start + 1;
+	double nS = groupS.position_end - groupS.position_start + 1;
+	double spanR = (double) (groupR.maxEnd - groupR.minStart) + 1;
+	double spanS = (double) (groupS.maxEnd - groupS.minStart) + 1;
+	double partitionsR = 1 + groupR.sumLength / spanR;
+	double partitionsS = 1 + groupS.sumLength / spanS;
+
+	double costNestedLoop = nR * nS / 4;
+	double costBguFS = (nR + nS) * (log2(nR + nS) + 2) + 2*1000;
+	double costDIP = nR * log2(partitionsR + 1) + nS * log2(partitionsS + 1) + partitionsS * nR + partitionsR * nS;
+
+	if ( (costNestedLoop <= costBguFS) && (costNestedLoop <= costDIP) )
+		return NESTED_LOOP;
+	return (costDIP < costBguFS) ? DIP : BGU_FS;
+}
+
+/*
+Moves cursor to the next group of directory range [cursor,end) that has to be joined and returns it in g.
+Groups with an empty complement and, if pruneDisjoint is set, pairs that can't overlap in time are skipped.
+Returns false if the range has no such group left
+*/
+bool next_group( uint32_t& cursor, uint32_t end, uint32_t* groupOfR, uint32_t* groupOfS, Borders& bordersR, Borders& bordersS, bool pruneDisjoint, uint32_t& g)
+{
+	for (; cursor < end; cursor++)
+	{
+		uint32_t curr_r = groupOfR[cursor];
+		uint32_t curr_s = groupOfS[cursor];
+
+		// skip groups with an empty complement
+		if ( (bordersS.borders_list[curr_s].position_start == 1) && (bordersS.borders_list[curr_s].position_end == 0) )
+			continue;
+		if ( pruneDisjoint && groupsDisjoint(bordersR.borders_list[curr_r], bordersS.borders_list[curr_s]) )
+			continue;
+
+		g = cursor++;
+		return true;
+	}
+
+	return false;
+}
+
+/*
+Loads groups of one side of the directory into F, one after the other on a single timeline:
+the i-th group of groups gets i in the bits above shift, so its tuples keep their timestamps in the low bits
+and can't overlap with tuples of other groups. The checksums of pairs are those of the original timestamps.
+Each group is trimmed to the window it can overlap with its counterpart, whose groups are in groupOfOther
+*/
+void load_flat(Relation& F, ExtendedRelation& ex, Borders& borders, uint32_t* groupOf, Borders& bordersOther, uint32_t* groupOfOther, std::vector<uint32_t>& groups, uint32_t shift)
+{
+	std::vector<Position> sizes(groups.size());
+	size_t numRecords = 0;
+	for (size_t i = 0; i < groups.size(); i++)
+	{
+		BordersElement& group = borders.borders_list[ groupOf[groups[i]] ];
+		Position till = trim_group( ex, group.position_start, group.position_end, bordersOther.borders_list[ groupOfOther[groups[i]] ].maxEnd);
+		sizes[i] = till - group.position_start + 1;
+		numRecords += sizes[i];
+	}
+
+	F.record_list = (Record*) large_malloc( std::max(numRecords, (size_t) 1) * sizeof(Record) );
+	F.numRecords = numRecords;
+
+	Record* r = F.record_list;
+	for (size_t i = 0; i < groups.size(); i++)
+	{
+		Timestamp offset = ((Timestamp) i) << shift;
+		Position from = borders.borders_list[ groupOf[groups[i]] ].position_start;
+		for (Position j = 0; j < sizes[i]; j++, r++)
+		{
+			r->start = offset | ex.getStart(from + j);
+			r->end = offset | ex.getEnd(from + j);
+
+			F.minStart = std::min(F.minStart, r->start);
+			F.maxStart = std::max(F.maxStart, r->start);
+			F.minEnd   = std::min(F.minEnd  , r->end);
+			F.maxEnd   = std::max(F.maxEnd  , r->end);
+		}
+	}
+}
+
+/* flat scan - one bguFS over all group pairs of a range of the directory, without setting up each pair */
+void* worker_flat_fs(void* args)
+{
+	structForParallelFS *gained = (structForParallelFS*) args;
+
+	// groups of the range that have to be joined
+	std::vector<uint32_t> groups;
+	uint32_t cursor = gained->directory_start, g;
+	while ( next_group( cursor, gained->directory_end, gained->groupOfR, gained->groupOfS, *(gained->bordersR), *(gained->bordersS), true, g) )
+		groups.push_back(g);
+
+	Relation R, S;
+	load_flat( R, *(gained->exR), *(gained->bordersR), gained->groupOfR, *(gained->bordersS), gained->groupOfS, groups, gained->shift);
+	load_flat( S, *(gained->exS), *(gained->bordersS), gained->groupOfS, *(gained->bordersR), gained->groupOfR, groups, gained->shift);
+
+	if ( (R.numRecords != 0) && (S.numRecords != 0) )
+	{
+		TemporalBucketIndex<Timestamp> BIR, BIS;
+		BIR.build(R, 1000);
+		BIS.build(S, 1000);
+
+		gained->thread_results[ gained->threadId ] += bguFS(R, S, BIR, BIS);
+	}
+
+	// make current thread free to be used for next group
+	gained->jobsList[ gained->threadId ] = 2;
+
+	return NULL;
+}
+
+/* Hands groups [first,end) of the directory to an available thread, to be joined in one flat scan */
+void dispatch_flat( ExtendedRelation& exR, Borders& bordersR, ExtendedRelation& exS, Borders& bordersS, uint32_t* groupOfR, uint32_t* groupOfS, uint32_t first, uint32_t end, uint32_t shift,
+					ThreadPlacement& placement, structForParallelFS* toPass, pthread_t* threads, uint32_t* jobsList, uint64_t* thread_results, uint32_t runNumThreads)
+{
+	bool needsDetach = false;
+	uint32_t threadId = getThreadId(needsDetach, jobsList, runNumThreads);
+	if (needsDetach)
+		if (pthread_detach(threads[threadId]))
+			printf("Whoops\n");
+
+	toPass[threadId].exR = &exR;
+	toPass[threadId].exS = &exS;
+	toPass[threadId].bordersR = &bordersR;
+	toPass[threadId].bordersS = &bordersS;
+	toPass[threadId].groupOfR = groupOfR;
+	toPass[threadId].groupOfS = groupOfS;
+	toPass[threadId].directory_start = first;
+	toPass[threadId].directory_end = end;
+	toPass[threadId].shift = shift;
+
+	toPass[threadId].threadId = threadId;
+	toPass[threadId].jobsList = jobsList;
+	toPass[threadId].thread_results = thread_results;
+
+	pthread_create( &threads[threadId], placement.attr(threadId), worker_flat_fs, &toPass[threadId]);
+}
+
+/*
+Joins each group of exR with the group of exS that has the same non-temporal values.
+Groups are matched through the directory of R and S - swapped is set if exR is (the complement of) S of the directory.
+Groups are joined with 32-bit timestamps if shortTimestamps is set.
+Each group belongs to the memory node its tuples of exR were written from, and a free thread takes the groups of its own node first
+*/
+uint64_t extended_temporal_join( ExtendedRelation& exR, Borders& bordersR, ExtendedRelation& exS, Borders& bordersS, GroupDirectory& directory, ThreadPlacement& placement, bool swapped, uint32_t runNumThreads, int algorithm, bool shortTimestamps, bool outerFlag)
 {
 	#ifdef TIMES
 	Timer tim;
@@ -217,74 +748,210 @@ uint64_t extended_temporal_join( ExtendedRelation& exR, Borders& bordersR, Exten
 	uint32_t threadId = 0;
 	bool needsDetach;
 
+	// groups of R and S in the directory (swapped if exR has the role of S in the directory)
+	uint32_t* groupOfR = swapped ? directory.groupS : directory.groupR;
+	uint32_t* groupOfS = swapped ? directory.groupR : directory.groupS;
+	uint32_t* denseOfR = swapped ? directory.denseS : directory.denseR;
+
 	// loop through Relations existing in ExtendedRelations
 	Timestamp domainStart = std::min(exR.minStart, exS.minStart);
 	Timestamp domainEnd = std::max(exR.maxEnd, exS.maxEnd);
-	uint32_t curr_r = 0;
-	uint32_t curr_s = 0;
-	while (curr_r != bordersR.numBorders)
+	uint32_t curr_r = 0, curr_s = 0;
+
+	// groups of R without a counterpart in S, handed to workers in batches of consecutive groups
+	if (outerFlag)
 	{
-		if (
-			(curr_s == bordersS.numBorders) ||
-			(bordersR.borders_list[curr_r].group1 < bordersS.borders_list[curr_s].group1) ||
-			((bordersR.borders_list[curr_r].group1 == bordersS.borders_list[curr_s].group1) && (bordersR.borders_list[curr_r].group2 < bordersS.borders_list[curr_s].group2))
-		)
+		uint32_t outer_first = 0;
+		uint32_t outer_count = 0;
+		size_t outer_records = 0;
+		size_t outer_batch_limit = std::max( exR.numRecords / (4*runNumThreads), (size_t) 1);
+		for (curr_r = 0; curr_r < bordersR.numBorders; curr_r++)
 		{
-			if (outerFlag)
+			if (denseOfR[curr_r] != NO_MATCH)
 			{
-				// join between R and time_domain (= R)
-#ifdef WORKLOAD_COUNT
-				result += bordersR.borders_list[curr_r].position_end - bordersR.borders_list[curr_r].position_start + 1;
-#else
-				for (uint32_t i = bordersR.borders_list[curr_r].position_start; i < bordersR.borders_list[curr_r].position_end ; i++)
-					result += domainStart ^ exR.record_list[i].start;
-#endif
+				if (outer_count != 0)
+					dispatch_outer_only( exR, bordersR, outer_first, curr_r-1, domainStart, placement, toPass, threads, jobsList, thread_results, runNumThreads);
+				outer_count = 0;
+				outer_records = 0;
+				continue;
 			}
 
-			curr_r++;
+			// join between R and time_domain (= R) - add group to current batch, hand batch to a worker once big enough
+			if (outer_count == 0)
+				outer_first = curr_r;
+			outer_count++;
+			outer_records += bordersR.borders_list[curr_r].position_end - bordersR.borders_list[curr_r].position_start + 1;
+			if (outer_records >= outer_batch_limit)
+			{
+				dispatch_outer_only( exR, bordersR, outer_first, curr_r, domainStart, placement, toPass, threads, jobsList, thread_results, runNumThreads);
+				outer_count = 0;
+				outer_records = 0;
+			}
 		}
-		else if (
-				(bordersR.borders_list[curr_r].group1 > bordersS.borders_list[curr_s].group1) ||
-				((bordersR.borders_list[curr_r].group1 == bordersS.borders_list[curr_s].group1) && (bordersR.borders_list[curr_r].group2 > bordersS.borders_list[curr_s].group2))
-				)
+		if (outer_count != 0)
+			dispatch_outer_only( exR, bordersR, outer_first, bordersR.numBorders-1, domainStart, placement, toPass, threads, jobsList, thread_results, runNumThreads);
+	}
+
+	// groups of R with a counterpart in S
+	// (overlap-only algorithms and inner DIP only compute overlaps, so pairs that can't overlap in time are dropped)
+	bool pruneDisjoint = computesOverlapsOnly(algorithm) || ( (algorithm == DIP) && !outerFlag );
+	size_t totalRecords = exR.numRecords + exS.numRecords;
+	uint32_t g = 0;
+
+	// flat scans place each group of a range above the bits of the timestamps, so the indexes of the groups have to fit in the rest
+	// (ends are taken from the zone maps, since complements don't keep the bounds of their relation)
+	uint32_t shift = 1, groupBits = 1;
+	if (algorithm == FLAT_FS)
+	{
+		Timestamp maxEnd = 0;
+		for (g = 0; g < directory.numGroups; g++)
 		{
-			curr_s++;
+			BordersElement& groupS = bordersS.borders_list[ groupOfS[g] ];
+			if ( (groupS.position_start == 1) && (groupS.position_end == 0) )
+				continue;
+			maxEnd = std::max( maxEnd, std::max(bordersR.borders_list[ groupOfR[g] ].maxEnd, groupS.maxEnd) );
 		}
-		else
+		while ( (shift < 64) && ((maxEnd >> shift) != 0) )
+			shift++;
+		while ( (groupBits < 32) && ((directory.numGroups >> groupBits) != 0) )
+			groupBits++;
+		if (shift + groupBits > 64)
 		{
-			if ( (bordersS.borders_list[curr_s].position_start != 1) || (bordersS.borders_list[curr_s].position_end != 0) )
+			#ifdef TIMES
+			std::cout << "Timestamps too wide for flat scans, joining each group pair with bguFS" << std::endl;
+			#endif
+			algorithm = BGU_FS;
+		}
+	}
+
+	// flat scans split the directory in one range per thread, with about the same number of tuples each
+	if (algorithm == FLAT_FS)
+	{
+		size_t range_limit = std::max( totalRecords / runNumThreads, (size_t) 1);
+		size_t range_records = 0;
+		uint32_t range_first = 0;
+		for (g = 0; g < directory.numGroups; g++)
+		{
+			range_records += (bordersR.borders_list[ groupOfR[g] ].position_end - bordersR.borders_list[ groupOfR[g] ].position_start + 1)
+							+ (bordersS.borders_list[ groupOfS[g] ].position_end - bordersS.borders_list[ groupOfS[g] ].position_start + 1);
+			if ( (range_records >= range_limit) || (g == directory.numGroups-1) )
 			{
-				needsDetach = false;
-				threadId = getThreadId(needsDetach, jobsList, runNumThreads);
-				if (needsDetach)
-					if (pthread_detach(threads[threadId]))
-						printf("Whoops\n");
-
-				toPass[threadId].exR = &exR;
-				toPass[threadId].exS = &exS;
-				toPass[threadId].R_start = bordersR.borders_list[curr_r].position_start;
-				toPass[threadId].R_end = bordersR.borders_list[curr_r].position_end;
-				toPass[threadId].S_start = bordersS.borders_list[curr_s].position_start;
-				toPass[threadId].S_end = bordersS.borders_list[curr_s].position_end;
-
-				toPass[threadId].threadId = threadId;
-				toPass[threadId].jobsList = jobsList;
-				toPass[threadId].thread_results = thread_results;
-
-				toPass[threadId].domainStart = domainStart;
-				toPass[threadId].domainEnd = domainEnd;
-
-				if (algorithm == BGU_FS)
-					pthread_create( &threads[threadId], NULL, worker_bguFS, &toPass[threadId]);
-				else if (algorithm == DIP)
-					pthread_create( &threads[threadId], NULL, outerFlag ? worker_dip_anti : worker_dip_inner, &toPass[threadId]);
-				else if (algorithm == O_DIP)
-					pthread_create( &threads[threadId], NULL, worker_o_dip_anti, &toPass[threadId]);
+				dispatch_flat( exR, bordersR, exS, bordersS, groupOfR, groupOfS, range_first, g+1, shift, placement, toPass, threads, jobsList, thread_results, runNumThreads);
+				range_first = g+1;
+				range_records = 0;
 			}
+		}
+	}
+
+	// directory ranges of the groups of each node - groups are in the order of their positions in exR
+	uint32_t numNodes = placement.numNodes;
+	uint32_t nodeCursor[numNodes], nodeEnd[numNodes];
+	g = 0;
+	for (uint32_t n = 0; n < numNodes; n++)
+	{
+		nodeCursor[n] = g;
+		while ( (g < directory.numGroups) && (placement.nodeOfPosition( bordersR.borders_list[ groupOfR[g] ].position_start, exR.numRecords) <= n) )
+			g++;
+		nodeEnd[n] = g;
+	}
+	nodeEnd[numNodes-1] = directory.numGroups;
+
+	// OIP splits a group in tasks by its share of the tuples, so that a big group is joined by many threads
+	uint32_t part = 0, numParts = 0;
+	void* oipGroup = NULL;
+	// (flat scans have taken all groups already)
+	while (algorithm != FLAT_FS)
+	{
+		needsDetach = false;
+		threadId = getThreadId(needsDetach, jobsList, runNumThreads);
 
-			curr_r++;
-			curr_s++;
+		if (part == numParts)
+		{
+			// next group of the node of the thread, else of any other node
+			uint32_t node = placement.nodeOfThread[threadId];
+			bool found = next_group( nodeCursor[node], nodeEnd[node], groupOfR, groupOfS, bordersR, bordersS, pruneDisjoint, g);
+			for (uint32_t n = 0; (n < numNodes) && !found; n++)
+				found = next_group( nodeCursor[n], nodeEnd[n], groupOfR, groupOfS, bordersR, bordersS, pruneDisjoint, g);
+			if (!found)
+			{
+				// no group left, give thread back
+				jobsList[threadId] = needsDetach ? 2 : 1;
+				break;
+			}
+			curr_r = groupOfR[g];
+			curr_s = groupOfS[g];
+
+			part = 0;
+			numParts = 1;
+			if (algorithm == OIP)
+			{
+				size_t groupRecords = (bordersR.borders_list[curr_r].position_end - bordersR.borders_list[curr_r].position_start + 1)
+									+ (bordersS.borders_list[curr_s].position_end - bordersS.borders_list[curr_s].position_start + 1);
+				numParts = std::max( (uint32_t) ((groupRecords * runNumThreads) / std::max(totalRecords, (size_t) 1)), (uint32_t) 1);
+				oipGroup = shortTimestamps ? (void*) new OipGroup<ShortTimestamp>(numParts) : (void*) new OipGroup<Timestamp>(numParts);
+			}
 		}
+
+		if (needsDetach)
+			if (pthread_detach(threads[threadId]))
+				printf("Whoops\n");
+
+		toPass[threadId].exR = &exR;
+		toPass[threadId].exS = &exS;
+		toPass[threadId].R_start = bordersR.borders_list[curr_r].position_start;
+		toPass[threadId].R_end = bordersR.borders_list[curr_r].position_end;
+		toPass[threadId].S_start = bordersS.borders_list[curr_s].position_start;
+		toPass[threadId].S_end = bordersS.borders_list[curr_s].position_end;
+		toPass[threadId].groupR = &bordersR.borders_list[curr_r];
+		toPass[threadId].groupS = &bordersS.borders_list[curr_s];
+
+		toPass[threadId].threadId = threadId;
+		toPass[threadId].jobsList = jobsList;
+		toPass[threadId].thread_results = thread_results;
+
+		toPass[threadId].domainStart = domainStart;
+		toPass[threadId].domainEnd = domainEnd;
+
+		toPass[threadId].part = part++;
+		toPass[threadId].numParts = numParts;
+		toPass[threadId].oipGroup = oipGroup;
+
+		// the planner joins complements for outer joins, so it only uses overlap joins
+		int kernel = algorithm;
+		if (algorithm == PLANNER)
+		{
+			kernel = plan_group( bordersR.borders_list[curr_r], bordersS.borders_list[curr_s]);
+			plannedGroups[kernel]++;
+		}
+
+		if (kernel == BGU_FS)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_bguFS<ShortTimestamp> : worker_bguFS<Timestamp>, &toPass[threadId]);
+		else if ( (kernel == DIP) && outerFlag && (algorithm == DIP) )
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_dip_anti<ShortTimestamp> : worker_dip_anti<Timestamp>, &toPass[threadId]);
+		else if (kernel == DIP)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_dip_inner<ShortTimestamp> : worker_dip_inner<Timestamp>, &toPass[threadId]);
+		else if (kernel == NESTED_LOOP)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_nested_loop<ShortTimestamp> : worker_nested_loop<Timestamp>, &toPass[threadId]);
+		else if (algorithm == O_DIP)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_o_dip_anti<ShortTimestamp> : worker_o_dip_anti<Timestamp>, &toPass[threadId]);
+		else if (algorithm == HINT)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_hint<ShortTimestamp> : worker_hint<Timestamp>, &toPass[threadId]);
+		else if (algorithm == TIMELINE)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_timeline<ShortTimestamp> : worker_timeline<Timestamp>, &toPass[threadId]);
+		else if (algorithm == OIP)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_oip<ShortTimestamp> : worker_oip<Timestamp>, &toPass[threadId]);
+		else if (algorithm == EBI)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_ebi<ShortTimestamp> : worker_ebi<Timestamp>, &toPass[threadId]);
+		else if (algorithm == BG_FS)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_bguFS<ShortTimestamp, BG_FS> : worker_bguFS<Timestamp, BG_FS>, &toPass[threadId]);
+		else if (algorithm == PLAIN_FS)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_bguFS<ShortTimestamp, PLAIN_FS> : worker_bguFS<Timestamp, PLAIN_FS>, &toPass[threadId]);
+		else if (algorithm == AUTO_FS)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_bguFS<ShortTimestamp, AUTO_FS> : worker_bguFS<Timestamp, AUTO_FS>, &toPass[threadId]);
+		else if (algorithm == SPLIT_FS)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_split<ShortTimestamp> : worker_split<Timestamp>, &toPass[threadId]);
+		else if (algorithm == LEARNED_FS)
+			pthread_create( &threads[threadId], placement.attr(threadId), shortTimestamps ? worker_bguFS<ShortTimestamp, LEARNED_FS> : worker_bguFS<Timestamp, LEARNED_FS>, &toPass[threadId]);
 	}
 	for (uint32_t i=0; i < runNumThreads; i++)
 	{
@@ -313,19 +980,57 @@ int main(int argc, char **argv)
 	int joinType = -1;
 	int algorithm = -1;
 	int computations = 1;
+	int numKeys = 2;
+	char* stringColumns = NULL;
+	bool stringKeys[MAX_KEY_COLUMNS] = {false};
+	bool anyStringKeys = false;
+	int policy = PLACEMENT_NONE;
 
 	// Parse and check command line input.
-	if ( (argc != 11) && (argc != 9) )
+	if ( (argc < 9) || (argc % 2 == 0) )
 	{
-		printf("Usage: ./ij -j joinType -a algorithm -t threadNum -n computations_num FILE1 FILE2\n");
+		printf("Usage: ./ij -j joinType -a algorithm -t threadNum -n computations_num -k keys_num -d string_keys -p placement FILE1 FILE2\n");
 		printf("--Computations is not mandatory and set as 1 by default\n");
+		printf("--Keys (non-temporal attributes after start and end in each line) is not mandatory and set as 2 by default\n");
+		printf("--String keys (comma separated positions of keys that are strings, e.g. 1,3) is not mandatory, all keys are integers by default\n");
+		printf("--Placement (compact, scatter or physical) is not mandatory, threads are not pinned to cpus by default\n");
 		exit(1);
 	}
 	char c;
-	while ((c = getopt(argc, argv, "j:a:t:n:")) != -1)
+	while ((c = getopt(argc, argv, "j:a:t:n:k:d:p:")) != -1)
 	{
 		switch (c)
 		{
+			case 'd':
+				stringColumns = optarg;
+				break;
+			case 'p':
+				if (!strcmp(optarg,"compact"))
+				{
+					policy = PLACEMENT_COMPACT;
+				}
+				else if (!strcmp(optarg,"scatter"))
+				{
+					policy = PLACEMENT_SCATTER;
+				}
+				else if (!strcmp(optarg,"physical"))
+				{
+					policy = PLACEMENT_PHYSICAL;
+				}
+				else
+				{
+					printf("Unknown placement provided\n");
+					exit(1);
+				}
+				break;
+			case 'k':
+				numKeys = atoi(optarg);
+				if ( (numKeys < 0) || (numKeys > MAX_KEY_COLUMNS) )
+				{
+					printf("Between 0 and %d keys required\n", MAX_KEY_COLUMNS);
+					exit(1);
+				}
+				break;
 			case 'n':
 				computations = atoi(optarg);
 				if (computations <= 0)
@@ -374,6 +1079,50 @@ int main(int argc, char **argv)
 				{
 					algorithm = O_DIP;
 				}
+				else if (!strcmp(optarg,"HINT"))
+				{
+					algorithm = HINT;
+				}
+				else if (!strcmp(optarg,"Timeline"))
+				{
+					algorithm = TIMELINE;
+				}
+				else if (!strcmp(optarg,"OIP"))
+				{
+					algorithm = OIP;
+				}
+				else if (!strcmp(optarg,"EBI"))
+				{
+					algorithm = EBI;
+				}
+				else if (!strcmp(optarg,"bgFS"))
+				{
+					algorithm = BG_FS;
+				}
+				else if (!strcmp(optarg,"FS"))
+				{
+					algorithm = PLAIN_FS;
+				}
+				else if (!strcmp(optarg,"auto"))
+				{
+					algorithm = AUTO_FS;
+				}
+				else if (!strcmp(optarg,"planner"))
+				{
+					algorithm = PLANNER;
+				}
+				else if (!strcmp(optarg,"flat"))
+				{
+					algorithm = FLAT_FS;
+				}
+				else if (!strcmp(optarg,"split"))
+				{
+					algorithm = SPLIT_FS;
+				}
+				else if (!strcmp(optarg,"learned"))
+				{
+					algorithm = LEARNED_FS;
+				}
 				else
 				{
 					printf("Unknown Join algorithm provided\n");
@@ -389,8 +1138,11 @@ int main(int argc, char **argv)
 				}
 				break;
 			default:
-				printf("Usage: ./ij -j joinType -s algorithm -t threadNum -n computations_num FILE1 FILE2\n");
+				printf("Usage: ./ij -j joinType -s algorithm -t threadNum -n computations_num -k keys_num -d string_keys -p placement FILE1 FILE2\n");
 				printf("--Computations is not mandatory and set as 1 by default\n");
+				printf("--Keys (non-temporal attributes after start and end in each line) is not mandatory and set as 2 by default\n");
+				printf("--String keys (comma separated positions of keys that are strings, e.g. 1,3) is not mandatory, all keys are integers by default\n");
+				printf("--Placement (compact, scatter or physical) is not mandatory, threads are not pinned to cpus by default\n");
 				exit(1);
 		}
 	}
@@ -409,29 +1161,70 @@ int main(int argc, char **argv)
 		printf("No join algorithm provided\n");
 		exit(1);
 	}
+	if (stringColumns != NULL)
+	{
+		for (char* column = strtok(stringColumns, ","); column != NULL; column = strtok(NULL, ","))
+		{
+			int k = atoi(column);
+			if ( (k < 1) || (k > numKeys) )
+			{
+				printf("String keys must be between 1 and %d\n", numKeys);
+				exit(1);
+			}
+			stringKeys[k-1] = true;
+			anyStringKeys = true;
+		}
+	}
 	if (argc-optind < 2)
 	{
 		std::cout << "error - two input files must be specified" << std::endl;
 		return 1;
 	}
 
+	// place worker threads on the memory nodes and cpus, sorting runs on the main thread
+	ThreadPlacement placement;
+	placement.init( runNumThreads, policy);
+	placement.pinMaster();
+	#ifdef TIMES
+	placement.report();
+	#endif
+
 	// Load inputs
-	// Use 2 parallel threads
+	// Use 2 parallel threads, placed as the first two workers
 	ExtendedRelation exR, exS;
 	pthread_t thread_id[2];
 	struct LoadRelationStructure lrs[2];
 	lrs[0].rel = &exR;
 	lrs[0].filename = argv[ optind ];
+	lrs[0].numKeys = numKeys;
+	lrs[0].stringKeys = stringKeys;
 	lrs[1].rel = &exS;
 	lrs[1].filename = argv[ optind+1 ];
-	pthread_create( &thread_id[0], NULL, &ExtendedRelation::load_helper, (void*) &lrs[0]);
-	pthread_create( &thread_id[1], NULL, &ExtendedRelation::load_helper, (void*) &lrs[1]);
+	lrs[1].numKeys = numKeys;
+	lrs[1].stringKeys = stringKeys;
+	pthread_create( &thread_id[0], placement.attr(0), &ExtendedRelation::load_helper, (void*) &lrs[0]);
+	pthread_create( &thread_id[1], placement.attr( std::min( runNumThreads-1, (uint32_t) 1)), &ExtendedRelation::load_helper, (void*) &lrs[1]);
 	pthread_join( thread_id[0], NULL);
 	pthread_join( thread_id[1], NULL);
 	printf("Relations loaded.\n\n");
+	#ifdef TIMES
+	report_large_allocations("load");
+	#endif
 
 	auto totalStartTime = std::chrono::steady_clock::now();
 
+	// encode string non-temporal values with a dictionary shared by both relations
+	if (anyStringKeys)
+		mainEncodeKeys( exR, exS, placement, runNumThreads);
+
+	// pack non-temporal values of each tuple to a single key
+	mainPackKeys( exR, exS, placement, runNumThreads);
+
+	// drop tuples whose non-temporal values exist only in one relation, if they can't contribute to the result
+	bool filterR = (joinType == INNER_JOIN) || (joinType == RIGHT_OUTER_JOIN);
+	bool filterS = (joinType == INNER_JOIN) || (joinType == LEFT_OUTER_JOIN) || (joinType == ANTI_JOIN);
+	mainSemiJoin( exR, exS, filterR, filterS, placement, runNumThreads);
+
 	// sort
 	#ifdef TIMES
 	Timer tim;
@@ -448,86 +1241,101 @@ int main(int argc, char **argv)
 	// find borders of each group
 	Borders bordersR;
 	Borders bordersS;
-	mainBorders( exR, bordersR, exS, bordersS, runNumThreads);
+	mainBorders( exR, bordersR, exS, bordersS, placement, runNumThreads);
+
+	// drop non-temporal values from sorted tuples, they are kept in Borders
+	mainCompact( exR, exS, placement, runNumThreads);
+
+	// give dense ids to groups that exist in both relations
+	GroupDirectory directory;
+	mainGroupDirectory( bordersR, bordersS, directory, placement, runNumThreads);
+
+	// complements and domains of the join are inside [minStart,maxEnd] of the inputs
+	bool shortTimestamps = fitsShortTimestamps( std::min(exR.minStart, exS.minStart), std::max(exR.maxEnd, exS.maxEnd));
+	#ifdef TIMES
+	std::cout << "Join timestamps: " << (shortTimestamps ? 32 : 64) << " bits" << std::endl;
+	#endif
 
 	// run join using the algorithm provided
 	for (uint32_t i = 0; i < computations; i++)
 	{
 		printf("\n----------------------\n");
 		result = 0;
+		memset( plannedGroups, 0, sizeof(plannedGroups));
 
-		if (algorithm == BGU_FS)
+		// overlap-only algorithms compute outer and anti joins through the complements
+		if ( computesOverlapsOnly(algorithm) )
 		{
 			if (joinType == INNER_JOIN)
 			{
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, false);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, false);
 			}
 			else if (joinType == LEFT_OUTER_JOIN)
 			{
 				ExtendedRelation exS_complement;
 				Borders bordersS_complement;
-				convert_to_complement( exS, bordersS, exS_complement, bordersS_complement, exR.minStart, exR.maxEnd, runNumThreads);
+				convert_to_complement( exS, bordersS, exS_complement, bordersS_complement, exR.minStart, exR.maxEnd, placement, runNumThreads);
 
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, false);
-				result += extended_temporal_join( exR, bordersR, exS_complement, bordersS_complement, runNumThreads, algorithm, true);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, false);
+				result += extended_temporal_join( exR, bordersR, exS_complement, bordersS_complement, directory, placement, false, runNumThreads, algorithm, shortTimestamps, true);
 			}
 			else if (joinType == RIGHT_OUTER_JOIN)
 			{
 				ExtendedRelation exR_complement;
 				Borders bordersR_complement;
-				convert_to_complement( exR, bordersR, exR_complement, bordersR_complement, exS.minStart, exS.maxEnd, runNumThreads);
+				convert_to_complement( exR, bordersR, exR_complement, bordersR_complement, exS.minStart, exS.maxEnd, placement, runNumThreads);
 
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, false);
-				result += extended_temporal_join( exS, bordersS, exR_complement, bordersR_complement, runNumThreads, algorithm, true);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, false);
+				result += extended_temporal_join( exS, bordersS, exR_complement, bordersR_complement, directory, placement, true, runNumThreads, algorithm, shortTimestamps, true);
 			}
 			else if (joinType == FULL_OUTER_JOIN)
 			{
 				ExtendedRelation exS_complement;
 				Borders bordersS_complement;
-				convert_to_complement( exS, bordersS, exS_complement, bordersS_complement, exR.minStart, exR.maxEnd, runNumThreads);
+				convert_to_complement( exS, bordersS, exS_complement, bordersS_complement, exR.minStart, exR.maxEnd, placement, runNumThreads);
 
 				ExtendedRelation exR_complement;
 				Borders bordersR_complement;
-				convert_to_complement( exR, bordersR, exR_complement, bordersR_complement, exS.minStart, exS.maxEnd, runNumThreads);
+				convert_to_complement( exR, bordersR, exR_complement, bordersR_complement, exS.minStart, exS.maxEnd, placement, runNumThreads);
 
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, false);
-				result += extended_temporal_join( exR, bordersR, exS_complement, bordersS_complement, runNumThreads, algorithm, true);
-				result += extended_temporal_join( exS, bordersS, exR_complement, bordersR_complement, runNumThreads, algorithm, true);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, false);
+				result += extended_temporal_join( exR, bordersR, exS_complement, bordersS_complement, directory, placement, false, runNumThreads, algorithm, shortTimestamps, true);
+				result += extended_temporal_join( exS, bordersS, exR_complement, bordersR_complement, directory, placement, true, runNumThreads, algorithm, shortTimestamps, true);
 			}
 			else if (joinType == ANTI_JOIN)
 			{
 				ExtendedRelation exS_complement;
 				Borders bordersS_complement;
-				convert_to_complement( exS, bordersS, exS_complement, bordersS_complement, exR.minStart, exR.maxEnd, runNumThreads);
+				convert_to_complement( exS, bordersS, exS_complement, bordersS_complement, exR.minStart, exR.maxEnd, placement, runNumThreads);
 
-				result += extended_temporal_join( exR, bordersR, exS_complement, bordersS_complement, runNumThreads, algorithm, true);
+				result += extended_temporal_join( exR, bordersR, exS_complement, bordersS_complement, directory, placement, false, runNumThreads, algorithm, shortTimestamps, true);
 			}
 		}
 		else
 		{
 			if ( (joinType == INNER_JOIN) && (algorithm == DIP) )
 			{
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, false);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, false);
 			}
 			else if ( (joinType == LEFT_OUTER_JOIN) && (algorithm == DIP) )
 			{
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, false);
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, true);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, false);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, true);
 			}
 			else if ( (joinType == RIGHT_OUTER_JOIN) && (algorithm == DIP) )
 			{
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, false);
-				result += extended_temporal_join( exS, bordersS, exR, bordersR, runNumThreads, algorithm, true);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, false);
+				result += extended_temporal_join( exS, bordersS, exR, bordersR, directory, placement, true, runNumThreads, algorithm, shortTimestamps, true);
 			}
 			else if ( (joinType == FULL_OUTER_JOIN) && (algorithm == DIP) )
 			{
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, false);
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, true);
-				result += extended_temporal_join( exS, bordersS, exR, bordersR, runNumThreads, algorithm, true);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, false);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, true);
+				result += extended_temporal_join( exS, bordersS, exR, bordersR, directory, placement, true, runNumThreads, algorithm, shortTimestamps, true);
 			}
 			else if (joinType == ANTI_JOIN)
 			{
-				result += extended_temporal_join( exR, bordersR, exS, bordersS, runNumThreads, algorithm, true);
+				result += extended_temporal_join( exR, bordersR, exS, bordersS, directory, placement, false, runNumThreads, algorithm, shortTimestamps, true);
 			}
 			else
 			{
@@ -541,6 +1349,8 @@ int main(int argc, char **argv)
 	auto totalEndTime = std::chrono::steady_clock::now();
 
 	std::cout << "\nTotal count: " << result << std::endl;
+	if (algorithm == PLANNER)
+		std::cout << "Planned group pairs: " << plannedGroups[BGU_FS] << " bguFS, " << plannedGroups[DIP] << " DIP, " << plannedGroups[NESTED_LOOP] << " nested loop" << std::endl;
 	std::cout << "Total time: " << std::chrono::duration_cast<std::chrono::milliseconds>(totalEndTime - totalStartTime).count() << " ms" << std::endl;
 
 	return 0;